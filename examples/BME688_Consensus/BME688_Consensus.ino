@@ -0,0 +1,85 @@
+/**
+ **************************************************
+ *
+ * @file        BME688_Consensus.ino
+ *
+ * @brief       example demonstrates how to combine redundant BME688 sensors into
+ *              one consensus reading, and report sensors that disagree with the
+ *              others or get quarantined.
+ *
+ * @link        solde.red/333203
+ *
+ * @authors     Josip Šimun Kuči @ soldered.com
+ ***************************************************/
+#include "BME688-Soldered.h"  // Include the BME688 library
+#include "BME688-Consensus.h" // Include the multi-sensor consensus
+
+#define SENSOR_COUNT 2  // Two sensors fit on one I2C bus; three or more can also tell which one is wrong
+
+BME688 sensors[SENSOR_COUNT] = {BME688(0x76), BME688(0x77)}; // One object per sensor address
+BME688Consensus consensus;   // Median of the healthy sensors
+
+void setup() {
+    // Initialize serial communication at 115200 baud rate
+    Serial.begin(115200);
+
+    // Wait for serial port to connect (needed for native USB)
+    while (!Serial) {
+        delay(10);
+    }
+
+    // Initialize every BME688 sensor
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        if (!sensors[i].begin()) {
+            Serial.print("Failed to initialize BME688 #");
+            Serial.println(i);
+        }
+    }
+
+    // Temperatures more than 0.5 *C from the consensus count against a sensor's health
+    consensus.setLimit(BME688_CHANNEL_TEMPERATURE, 50);
+}
+
+void loop() {
+    BME688Sample samples[SENSOR_COUNT];
+    BME688Sample result;
+
+    // Read every sensor; a failed read keeps status 0 and counts against that sensor
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        if (!sensors[i].readSample(samples[i])) {
+            samples[i].status = 0;
+        }
+    }
+
+    uint8_t outliers = consensus.update(samples, SENSOR_COUNT, result);
+
+    Serial.print("Temperature: ");
+    Serial.print(result.temperature / 100.0);
+    Serial.println(" *C");
+    Serial.print("Pressure: ");
+    Serial.print(result.pressure);
+    Serial.println(" Pa");
+    Serial.print("Humidity: ");
+    Serial.print(result.humidity / 100.0);
+    Serial.println(" %");
+
+    // Print the health of every sensor (255 = always agrees with the consensus)
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        Serial.print("Sensor #");
+        Serial.print(i);
+        Serial.print(" health: ");
+        Serial.print(consensus.health(i));
+        if (consensus.quarantined() & (1 << i)) {
+            Serial.print(" (quarantined)");
+        } else if (outliers & (1 << i)) {
+            Serial.print(" (outlier)");
+        }
+        Serial.println();
+    }
+
+    // Add a separator line between readings
+    Serial.println("-----------------------");
+
+    // Wait 2 seconds before next reading
+    delay(2000);
+}
@@ -0,0 +1,119 @@
+/**
+ **************************************************
+ *
+ * @file        BME688_Derived_Values.ino
+ *
+ * @brief       example demonstrates how to calculate dew point, absolute humidity
+ *              and altitude from BME688 readings, and compares the run time of the
+ *              exact and fast variants of each calculation.
+ *
+ * @link        solde.red/333203
+ *
+ * @authors     Josip Šimun Kuči @ soldered.com
+ ***************************************************/
+#include "BME688-Soldered.h"  // Include the BME688 library
+#include "BME688-Derived.h"   // Include the derived quantity calculations
+
+#define BENCHMARK_RUNS 1000  // How many times each calculation is repeated when timing it
+
+BME688 sensor;  // Create an instance of the BME688 sensor object
+
+// Benchmark inputs and results are volatile, so the compiler can neither hoist the timed
+// calculations out of their loops nor drop them
+volatile float inTemperature, inHumidity, inPressure;
+volatile float sink;
+
+void setup() {
+    // Initialize serial communication at 115200 baud rate
+    Serial.begin(115200);
+
+    // Wait for serial port to connect (needed for native USB)
+    while (!Serial) {
+        delay(10);
+    }
+
+    // Initialize the BME688 sensor
+    if (sensor.begin()) {
+        Serial.println("BME688 Initialized Successfully!");
+    } else {
+        Serial.println("Failed to initialize BME688!");
+        // Halt program execution if initialization fails
+        while (1);
+    }
+}
+
+void loop() {
+    // Read temperature, pressure and humidity from a single conversion
+    BME688Sample sample;
+    if (!sensor.readSample(sample)) {
+        Serial.println("Failed to read sample!");
+        delay(2000);
+        return;
+    }
+    float temperature = sample.temperature / 100.0;
+    float humidity = sample.humidity / 100.0;
+    float pressure = sample.pressure;
+
+    // Exact and fast dew point
+    Serial.print("Dew point: ");
+    Serial.print(BME688Derived::dewPoint(temperature, humidity));
+    Serial.print(" °C (fast: ");
+    Serial.print(BME688Derived::dewPointFast(temperature, humidity));
+    Serial.println(" °C)");
+
+    // Exact and fast absolute humidity
+    Serial.print("Absolute humidity: ");
+    Serial.print(BME688Derived::absoluteHumidity(temperature, humidity));
+    Serial.print(" g/m3 (fast: ");
+    Serial.print(BME688Derived::absoluteHumidityFast(temperature, humidity));
+    Serial.println(" g/m3)");
+
+    // Exact and fast altitude, relative to standard sea level pressure
+    Serial.print("Altitude: ");
+    Serial.print(BME688Derived::altitude(pressure));
+    Serial.print(" m (fast: ");
+    Serial.print(BME688Derived::altitudeFast(pressure));
+    Serial.println(" m)");
+
+    // Time each calculation, in microseconds per call
+    unsigned long start;
+    inTemperature = temperature;
+    inHumidity = humidity;
+    inPressure = pressure;
+
+    Serial.print("dewPoint: ");
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) sink += BME688Derived::dewPoint(inTemperature, inHumidity);
+    Serial.print((micros() - start) / (float)BENCHMARK_RUNS);
+    Serial.print(" us, dewPointFast: ");
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) sink += BME688Derived::dewPointFast(inTemperature, inHumidity);
+    Serial.print((micros() - start) / (float)BENCHMARK_RUNS);
+    Serial.println(" us");
+
+    Serial.print("absoluteHumidity: ");
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) sink += BME688Derived::absoluteHumidity(inTemperature, inHumidity);
+    Serial.print((micros() - start) / (float)BENCHMARK_RUNS);
+    Serial.print(" us, absoluteHumidityFast: ");
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) sink += BME688Derived::absoluteHumidityFast(inTemperature, inHumidity);
+    Serial.print((micros() - start) / (float)BENCHMARK_RUNS);
+    Serial.println(" us");
+
+    Serial.print("altitude: ");
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) sink += BME688Derived::altitude(inPressure);
+    Serial.print((micros() - start) / (float)BENCHMARK_RUNS);
+    Serial.print(" us, altitudeFast: ");
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) sink += BME688Derived::altitudeFast(inPressure);
+    Serial.print((micros() - start) / (float)BENCHMARK_RUNS);
+    Serial.println(" us");
+
+    // Add a separator line between readings
+    Serial.println("-----------------------");
+
+    // Wait 2 seconds before next reading
+    delay(2000);
+}
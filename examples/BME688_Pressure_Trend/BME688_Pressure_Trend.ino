@@ -0,0 +1,73 @@
+/**
+ **************************************************
+ *
+ * @file        BME688_Pressure_Trend.ino
+ *
+ * @brief       example demonstrates how to track the barometric tendency with the
+ *              BME688, print the 3-hour pressure change and the pressure slope, and
+ *              warn when pressure is falling fast enough to signal a storm.
+ *
+ * @link        solde.red/333203
+ *
+ * @authors     Josip Šimun Kuči @ soldered.com
+ ***************************************************/
+#include "BME688-Soldered.h"  // Include the BME688 library
+#include "BME688-Trend.h"     // Include the pressure trend tracker
+
+#define TENDENCY_HORIZON 10800  // Tendency horizon in seconds (3 hours)
+#define STORM_THRESHOLD  -300   // 3-hour pressure change that triggers a storm warning (Pa)
+
+BME688 sensor;               // Create an instance of the BME688 sensor object
+BME688PressureTrend trend;   // Pressure history in 5 minute slots
+
+void setup() {
+    // Initialize serial communication at 115200 baud rate
+    Serial.begin(115200);
+
+    // Wait for serial port to connect (needed for native USB)
+    while (!Serial) {
+        delay(10);
+    }
+
+    // Initialize the BME688 sensor
+    if (sensor.begin()) {
+        Serial.println("BME688 Initialized Successfully!");
+    } else {
+        Serial.println("Failed to initialize BME688!");
+        // Halt program execution if initialization fails
+        while (1);
+    }
+}
+
+void loop() {
+    // Add the current pressure to the history. Time is in seconds; on a board that
+    // sleeps, use an RTC and keep trend.state() in RTC memory across deep sleep.
+    trend.add(millis() / 1000, sensor.readPressure());
+
+    Serial.print("Pressure: ");
+    Serial.print(trend.latest());
+    Serial.println(" Pa");
+
+    // The tendency is NAN until the history covers the whole horizon
+    float tendency = trend.tendency(TENDENCY_HORIZON);
+    Serial.print("3-hour tendency: ");
+    if (isnan(tendency)) {
+        Serial.println("collecting history...");
+    } else {
+        Serial.print(tendency);
+        Serial.println(" Pa");
+        if (tendency <= STORM_THRESHOLD) {
+            Serial.println("Storm warning: pressure is falling fast!");
+        }
+    }
+
+    Serial.print("Slope: ");
+    Serial.print(trend.slope());
+    Serial.println(" Pa/h");
+
+    // Add a separator line between readings
+    Serial.println("-----------------------");
+
+    // Wait 1 minute before next reading
+    delay(60000);
+}
@@ -0,0 +1,154 @@
+/**
+ **************************************************
+ *
+ * @file        BME688_Sample_Log.ino
+ *
+ * @brief       example demonstrates how to buffer BME688 samples in a compact binary
+ *              log on an SD card, dump the whole log, and query the last minute of
+ *              samples by time.
+ *
+ * @link        solde.red/333203
+ *
+ * @authors     Josip Šimun Kuči @ soldered.com
+ ***************************************************/
+#include <SD.h>               // Include the SD card library
+#include "BME688-Soldered.h"  // Include the BME688 library
+#include "BME688-Log.h"       // Include the sample log
+
+#define SD_CS_PIN      10      // Chip select pin of the SD card
+#define LOG_FILE       "/bme688.log"
+#define LOG_PAGE_SIZE  512     // Bytes per log page (27 samples)
+#define LOG_PAGE_COUNT 64      // Pages in the log file (32 KB, about 1700 samples)
+
+/**
+ * Block device backed by a fixed-size file. Erased pages are filled with 0xFF,
+ * like the sectors of a flash chip.
+ */
+class FileBlockDevice : public BME688BlockDevice {
+  public:
+    bool begin() {
+        // FILE_WRITE appends every write, so open for random access instead
+        file = SD.open(LOG_FILE, O_READ | O_WRITE | O_CREAT);
+        if (!file) {
+            return false;
+        }
+        // Grow the file to its full size on first use
+        file.seek(file.size());
+        while (file.size() < (uint32_t)LOG_PAGE_SIZE * LOG_PAGE_COUNT) {
+            file.write(0xFF);
+        }
+        return true;
+    }
+
+    uint16_t pageSize() { return LOG_PAGE_SIZE; }
+    uint32_t pageCount() { return LOG_PAGE_COUNT; }
+
+    bool read(uint32_t page, uint16_t offset, void *data, uint16_t length) {
+        return file.seek((uint32_t)page * LOG_PAGE_SIZE + offset) &&
+               file.read((uint8_t *)data, length) == length;
+    }
+
+    bool program(uint32_t page, uint16_t offset, const void *data, uint16_t length) {
+        bool ok = file.seek((uint32_t)page * LOG_PAGE_SIZE + offset) &&
+                  file.write((const uint8_t *)data, length) == length;
+        file.flush();
+        return ok;
+    }
+
+    bool erase(uint32_t page) {
+        uint8_t blank[32];
+        memset(blank, 0xFF, sizeof(blank));
+        if (!file.seek((uint32_t)page * LOG_PAGE_SIZE)) {
+            return false;
+        }
+        for (uint16_t i = 0; i < LOG_PAGE_SIZE; i += sizeof(blank)) {
+            file.write(blank, sizeof(blank));
+        }
+        file.flush();
+        return true;
+    }
+
+  private:
+    File file;
+};
+
+BME688 sensor;                // Create an instance of the BME688 sensor object
+FileBlockDevice storage;      // Log file on the SD card
+BME688Log sampleLog(storage); // Sample log on top of the file
+
+uint32_t timeOffset = 0;      // Keeps timestamps increasing across resets
+uint32_t lastStored = 0;      // Timestamp of the newest stored sample
+
+// Print one sample from the log
+bool printSample(const BME688Sample &sample, void *context) {
+    Serial.print(sample.timestamp);
+    Serial.print(" ms: ");
+    Serial.print(sample.temperature / 100.0);
+    Serial.print(" *C, ");
+    Serial.print(sample.pressure);
+    Serial.print(" Pa, ");
+    Serial.print(sample.humidity / 100.0);
+    Serial.println(" %");
+    return true;  // Return false to stop reading
+}
+
+// Remember the newest timestamp in the log
+bool findNewest(const BME688Sample &sample, void *context) {
+    lastStored = sample.timestamp;
+    return true;
+}
+
+void setup() {
+    // Initialize serial communication at 115200 baud rate
+    Serial.begin(115200);
+
+    // Wait for serial port to connect (needed for native USB)
+    while (!Serial) {
+        delay(10);
+    }
+
+    // Initialize the BME688 sensor
+    if (!sensor.begin()) {
+        Serial.println("Failed to initialize BME688!");
+        // Halt program execution if initialization fails
+        while (1);
+    }
+
+    // Mount the log and find where the last run stopped
+    if (!SD.begin(SD_CS_PIN) || !storage.begin() || !sampleLog.begin()) {
+        Serial.println("Failed to open the sample log!");
+        while (1);
+    }
+
+    // Send everything stored so far, e.g. samples collected while the link was down
+    Serial.println("Stored samples:");
+    sampleLog.dump(printSample);
+
+    // Timestamps must never go backwards, so continue after the newest stored sample.
+    // With an RTC, store the RTC time instead.
+    sampleLog.dump(findNewest);
+    timeOffset = lastStored;
+}
+
+void loop() {
+    BME688Sample sample;
+    if (sensor.readSample(sample)) {
+        sample.timestamp += timeOffset;
+        if (!sampleLog.append(sample)) {
+            Serial.println("Failed to store the sample!");
+        }
+    }
+
+    // Print the samples of the last minute using the time index
+    uint32_t now = millis() + timeOffset;
+    Serial.println("Last minute:");
+    uint32_t count = sampleLog.query(now > 60000 ? now - 60000 : 0, now, printSample);
+    Serial.print(count);
+    Serial.println(" samples");
+
+    // Add a separator line between readings
+    Serial.println("-----------------------");
+
+    // Wait 10 seconds before next reading
+    delay(10000);
+}
@@ -0,0 +1,188 @@
+/**
+ **************************************************
+ * @file        compensation_benchmark.cpp
+ * @brief       Host benchmark of the folded compensation coefficients against
+ *              the Bosch double formulas they replace: speed and largest
+ *              difference (build with extras/host_tests.sh)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include "BME688-Soldered.h"
+#include <chrono>
+#include <stdlib.h>
+
+#define BENCHMARK_RUNS 1000000 ///< Compensated samples per timed run
+#define INPUT_COUNT    64      ///< Distinct inputs cycled through, so results can't be reused
+
+/**
+ * @class Compensation
+ * @brief Exposes the compensation of the driver to the benchmark.
+ */
+class Compensation : public BME688
+{
+  public:
+    using BME688::Calibration;
+    using BME688::Coefficients;
+    using BME688::readUCHum;
+    using BME688::readUCPres;
+    using BME688::readUCTemp;
+
+    Compensation(const Calibration &c)
+    {
+        foldCalibration(c);
+    }
+
+    const Coefficients &coefficients()
+    {
+        return coef;
+    }
+
+    uint8_t heater(uint16_t target)
+    {
+        return readUCGas(coef, target);
+    }
+};
+
+// Typical calibration constants of one sensor
+static Compensation::Calibration calibration()
+{
+    Compensation::Calibration c;
+    c.par_t1 = 26341, c.par_t2 = 26243, c.par_t3 = 3;
+    c.par_p1 = 36415, c.par_p2 = -10446, c.par_p3 = 88, c.par_p4 = 8772, c.par_p5 = -30, c.par_p6 = 30;
+    c.par_p7 = 30, c.par_p8 = -3078, c.par_p9 = 7923, c.par_p10 = 30;
+    c.par_h1 = 739, c.par_h2 = 1016, c.par_h3 = 0, c.par_h4 = 45, c.par_h5 = 20, c.par_h6 = 120, c.par_h7 = -100;
+    c.par_g1 = -24, c.par_g2 = 17664, c.par_g3 = 18, c.res_heat_val = 41, c.res_heat_range = 25;
+    return c;
+}
+
+// Bosch floating point formulas, as computed per sample before the coefficients were folded
+
+static double referenceTemp(const Compensation::Calibration &c, int32_t adc_T)
+{
+    double var1 = (((double)adc_T / 16384.0) - ((double)c.par_t1 / 1024.0)) * (double)c.par_t2;
+    double var2 = ((((double)adc_T / 131072.0) - ((double)c.par_t1 / 8192.0)) *
+                   (((double)adc_T / 131072.0) - ((double)c.par_t1 / 8192.0))) *
+                  ((double)c.par_t3 * 16.0);
+    return var1 + var2;
+}
+
+static double referencePres(const Compensation::Calibration &c, int32_t adc_P, double t_fine)
+{
+    double var1 = 0.0, var2 = 0.0, var3 = 0.0;
+    double press_comp = 0.0;
+
+    var1 = ((double)t_fine / 2.0) - 64000.0;
+    var2 = var1 * var1 * ((double)c.par_p6 / 131072.0);
+    var2 = var2 + (var1 * (double)c.par_p5 * 2.0);
+    var2 = (var2 / 4.0) + ((double)c.par_p4 * 65536.0);
+    var1 = ((((double)c.par_p3 * var1 * var1) / 16384.0) + ((double)c.par_p2 * var1)) / 524288.0;
+    var1 = (1.0 + (var1 / 32768.0)) * (double)c.par_p1;
+    press_comp = 1048576.0 - (double)adc_P;
+    press_comp = ((press_comp - (var2 / 4096.0)) * 6250.0) / var1;
+    var1 = ((double)c.par_p9 * press_comp * press_comp) / 2147483648.0;
+    var2 = press_comp * ((double)c.par_p8 / 32768.0);
+    var3 = (press_comp / 256.0) * (press_comp / 256.0) * (press_comp / 256.0) * ((double)c.par_p10 / 131072.0);
+    return press_comp + (var1 + var2 + var3 + ((double)c.par_p7 * 128.0)) / 16.0;
+}
+
+static double referenceHum(const Compensation::Calibration &c, uint16_t adc_H, double t_fine)
+{
+    t_fine /= 5120.0;
+    double var1 = 0, var2 = 0, var3 = 0, var4 = 0;
+
+    var1 = adc_H - (((double)c.par_h1 * 16.0) + (((double)c.par_h3 / 2.0) * t_fine));
+    var2 = var1 * (((double)c.par_h2 / 262144.0) *
+                   (1.0 + (((double)c.par_h4 / 16384.0) * t_fine) + (((double)c.par_h5 / 1048576.0) * t_fine * t_fine)));
+    var3 = (double)c.par_h6 / 16384.0;
+    var4 = (double)c.par_h7 / 2097152.0;
+    return var2 + ((var3 + (var4 * t_fine)) * var2 * var2);
+}
+
+static uint8_t referenceHeater(const Compensation::Calibration &c, uint16_t target, double ambient)
+{
+    double var1 = ((double)c.par_g1 / 16.0) + 49.0;
+    double var2 = (((double)c.par_g2 / 32768.0) * 0.0005) + 0.00235;
+    double var3 = (double)c.par_g3 / 1024.0;
+    double var4 = var1 * (1.0 + (var2 * (double)target));
+    double var5 = var4 + (var3 * ambient);
+    return (uint8_t)(3.4 * ((var5 * (4.0 / (4.0 + (double)((c.res_heat_range & BME_688_HEAT_RANGE_MASK) >> 4))) *
+                             (1.0 / (1.0 + ((double)c.res_heat_val * 0.002)))) -
+                            25));
+}
+
+// Inputs are read through volatile and results go to a volatile sink, so the optimizer can
+// neither hoist the calls out of the loops nor drop them
+static volatile int32_t temperatures[INPUT_COUNT], pressures[INPUT_COUNT], humidities[INPUT_COUNT];
+static volatile double sink;
+
+template <typename Function> static void run(const char *name, Function compensate)
+{
+    double sum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCHMARK_RUNS; i++)
+        sum += compensate(i % INPUT_COUNT);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    sink = sink + sum;
+    printf("%-22s %8.2f ns/sample\n", name, elapsed.count() / BENCHMARK_RUNS);
+}
+
+static Compensation::Calibration constants = calibration();
+static Compensation folded(constants);
+
+// Temperature, pressure and humidity of one sample
+static double reference(long i)
+{
+    double t_fine = referenceTemp(constants, temperatures[i]);
+    return t_fine + referencePres(constants, pressures[i], t_fine) + referenceHum(constants, humidities[i], t_fine);
+}
+
+static double precomputed(long i)
+{
+    const Compensation::Coefficients &k = folded.coefficients();
+    float t_fine = Compensation::readUCTemp(k, temperatures[i]);
+    return t_fine + Compensation::readUCPres(k, pressures[i], t_fine) +
+           Compensation::readUCHum(k, humidities[i], t_fine);
+}
+
+int main()
+{
+    // Raw values spanning about -40 to 85 °C, 30 to 110 kPa and 0 to 100 %RH
+    for (int i = 0; i < INPUT_COUNT; i++)
+    {
+        temperatures[i] = 380000 + 200000 * i / INPUT_COUNT;
+        pressures[i] = 250000 + 500000 * ((i * 23) % INPUT_COUNT) / INPUT_COUNT;
+        humidities[i] = 12000 + 30000 * ((i * 37) % INPUT_COUNT) / INPUT_COUNT;
+    }
+
+    run("Bosch double formulas", reference);
+    run("folded coefficients", precomputed);
+
+    // Largest difference over the same ranges, in output units
+    double temperature = 0, pressure = 0, humidity = 0;
+    const Compensation::Coefficients &k = folded.coefficients();
+    for (int32_t adc_T = 380000; adc_T <= 580000; adc_T += 500)
+    {
+        double reference_t = referenceTemp(constants, adc_T);
+        float t_fine = Compensation::readUCTemp(k, adc_T);
+        temperature = fmax(temperature, fabs(t_fine / 5120.0 - reference_t / 5120.0));
+        for (int32_t adc_P = 250000; adc_P <= 750000; adc_P += 25000)
+            pressure = fmax(pressure, fabs(Compensation::readUCPres(k, adc_P, t_fine) -
+                                           referencePres(constants, adc_P, reference_t)));
+        for (int32_t adc_H = 12000; adc_H <= 42000; adc_H += 1500)
+            humidity = fmax(humidity, fabs(Compensation::readUCHum(k, adc_H, t_fine) -
+                                           referenceHum(constants, adc_H, reference_t)));
+    }
+    int heater = 0;
+    for (uint16_t target = 200; target <= 425; target++)
+    {
+        int difference = abs(folded.heater(target) - referenceHeater(constants, target, 25));
+        heater = difference > heater ? difference : heater;
+    }
+
+    printf("largest difference: %.5f °C, %.3f Pa, %.5f %%RH, %d LSB of res_heat\n", temperature, pressure,
+           humidity, heater);
+    return 0;
+}
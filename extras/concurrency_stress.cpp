@@ -0,0 +1,191 @@
+/**
+ **************************************************
+ * @file        concurrency_stress.cpp
+ * @brief       Host stress test of one BME688 object shared between threads
+ *              (build with extras/host_tests.sh, which runs it under ThreadSanitizer)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include "BME688-Soldered.h"
+#include "Wire.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define STRESS_ROUNDS     50  ///< Fresh sensor objects, each starting with lazy calibration
+#define STRESS_THREADS    8   ///< Threads sharing one object
+#define STRESS_ITERATIONS 200 ///< Calls per thread and round
+
+static std::mutex bus;
+static std::atomic<std::thread::id> owner;
+static std::atomic<unsigned> failures(0);
+static std::atomic<int> waiting(0);
+
+// Lock hooks with a re-entrancy check: taking the lock twice from one thread would deadlock on a target
+static void lockBus(void *)
+{
+    if (owner.load() == std::this_thread::get_id())
+    {
+        fprintf(stderr, "lock taken twice by one thread\n");
+        failures++;
+        return;
+    }
+    bus.lock();
+    owner = std::this_thread::get_id();
+}
+
+// Yielding a random number of times after every release interleaves the threads at each lock
+// boundary in varying orders, even on one core
+static void unlockBus(void *)
+{
+    static thread_local unsigned seed = std::hash<std::thread::id>()(std::this_thread::get_id());
+    owner = std::thread::id();
+    bus.unlock();
+    seed = seed * 1103515245 + 12345;
+    for (unsigned i = seed >> 16 & 3; i > 0; i--)
+        std::this_thread::yield();
+}
+
+// Calibration and raw results of a sensor at about 33 °C, 96 kPa and 72 %RH
+static void loadRegisters()
+{
+    static const uint8_t calibration[][2] = {
+        {0xE9, 0xE5}, {0xEA, 0x66}, {0x8A, 0x83}, {0x8B, 0x66}, {0x8C, 0x03}, {0x8E, 0x3F}, {0x8F, 0x8E},
+        {0x90, 0x32}, {0x91, 0xD7}, {0x92, 0x58}, {0x94, 0x44}, {0x95, 0x22}, {0x96, 0x1E}, {0x98, 0x1E},
+        {0x99, 0x00}, {0x9C, 0xFA}, {0x9D, 0xF3}, {0x9E, 0xF3}, {0x9F, 0x1E}, {0xA0, 0x1E}, {0xE1, 0x3F},
+        {0xE2, 0x83}, {0xE3, 0x2E}, {0xE4, 0x00}, {0xE5, 0x2D}, {0xE6, 0x14}, {0xE7, 0x78}, {0xE8, 0x9C},
+        {0xEB, 0x00}, {0xEC, 0x45}, {0xED, 0xE8}, {0xEE, 0x12}, {0x00, 0x29}, {0x02, 0x19}, {0x04, 0x0D}};
+    for (size_t i = 0; i < sizeof(calibration) / sizeof(calibration[0]); i++)
+        Wire.regs[calibration[i][0]] = calibration[i][1];
+
+    const uint8_t field[] = {0x80, 0x00, 0x5A, 0x5A, 0x50, 0x80, 0x80, 0x00, 0x60, 0x00,
+                             0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x34};
+    memcpy(Wire.results, field, sizeof(field));
+}
+
+static void worker(BME688 *sensor, int role)
+{
+    BME688Sample sample;
+
+    // Start all threads together, so several of them find the calibration not loaded yet
+    waiting--;
+    while (waiting > 0)
+        std::this_thread::yield();
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++)
+    {
+        switch ((role + i) % 6)
+        {
+        case 0:
+            sensor->readSample(sample);
+            break;
+        case 1:
+            sensor->readSample(sample, i % BME_688_GAS_PROFILE_COUNT);
+            break;
+        case 2:
+            sensor->readTemperature();
+            break;
+        case 3:
+            sensor->readPressure();
+            break;
+        case 4:
+            sensor->readHumidity();
+            break;
+        default:
+            sensor->readGas(i % BME_688_GAS_PROFILE_COUNT);
+            break;
+        }
+    }
+}
+
+// Values of the registers above, measured by one thread with nothing else running
+static double expectedTemperature, expectedPressure, expectedHumidity;
+
+// A conversion started by another thread may skip the channel a read asked for. The read must
+// then come back as NAN, never as the compensated skipped-channel marker.
+static void check(const char *name, double value, double expected)
+{
+    if (!isnan(value) && value != expected)
+    {
+        fprintf(stderr, "%s read %f instead of %f\n", name, value, expected);
+        failures++;
+    }
+}
+
+static void mixedWorker(BME688 *sensor, int role)
+{
+    BME688Sample sample;
+
+    waiting--;
+    while (waiting > 0)
+        std::this_thread::yield();
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++)
+    {
+        switch ((role + i) % 4)
+        {
+        case 0:
+            check("temperature", sensor->readTemperature(), expectedTemperature);
+            break;
+        case 1:
+            check("pressure", sensor->readPressure(), expectedPressure);
+            break;
+        case 2:
+            check("humidity", sensor->readHumidity(), expectedHumidity);
+            break;
+        default:
+            if (sensor->readSample(sample) && (sample.status & BME688_SAMPLE_PRESSURE))
+                check("sample pressure", sample.pressure, (uint32_t)(expectedPressure + 0.5));
+            break;
+        }
+    }
+}
+
+int main()
+{
+    loadRegisters();
+    for (int round = 0; round < STRESS_ROUNDS; round++)
+    {
+        // beginFast() defers calibration and heater setup, so the threads race to load them
+        BME688 sensor;
+        sensor.setBusLock(lockBus, unlockBus);
+        if (!sensor.beginFast())
+        {
+            fprintf(stderr, "beginFast() failed\n");
+            return 1;
+        }
+
+        std::vector<std::thread> threads;
+        waiting = STRESS_THREADS;
+        for (int i = 0; i < STRESS_THREADS; i++)
+            threads.push_back(std::thread(worker, &sensor, i));
+        for (size_t i = 0; i < threads.size(); i++)
+            threads[i].join();
+    }
+
+    // Temperature-only and pressure reads on different threads overlap their conversions
+    BME688 sensor;
+    sensor.setBusLock(lockBus, unlockBus);
+    sensor.beginFast();
+    expectedTemperature = sensor.readTemperature();
+    expectedPressure = sensor.readPressure();
+    expectedHumidity = sensor.readHumidity();
+    for (int round = 0; round < STRESS_ROUNDS; round++)
+    {
+        std::vector<std::thread> threads;
+        waiting = STRESS_THREADS;
+        for (int i = 0; i < STRESS_THREADS; i++)
+            threads.push_back(std::thread(mixedWorker, &sensor, i));
+        for (size_t i = 0; i < threads.size(); i++)
+            threads[i].join();
+    }
+
+    printf("%d rounds x %d threads x %d calls: %s\n", STRESS_ROUNDS, STRESS_THREADS, STRESS_ITERATIONS,
+           failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+/**
+ **************************************************
+ * @file        consensus_test.cpp
+ * @brief       Host test of the multi-sensor consensus with injected faulty
+ *              sensor streams (build with extras/host_tests.sh)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include "BME688-Consensus.h"
+
+// With up to four sensors the trimmed mean equals the median, so the library is built for eight
+#if BME688_CONSENSUS_MAX < 8
+#error "Build with -DBME688_CONSENSUS_MAX=8"
+#endif
+
+static unsigned failures = 0;
+
+#define CHECK(condition)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                              \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+static BME688Sample sampleOf(int16_t temperature, uint32_t pressure = 100000, uint16_t humidity = 4000,
+                             uint8_t status = BME688_SAMPLE_TPH)
+{
+    BME688Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.timestamp = 1000;
+    sample.temperature = temperature;
+    sample.pressure = pressure;
+    sample.humidity = humidity;
+    sample.status = status;
+    return sample;
+}
+
+static void testMedian()
+{
+    BME688Consensus consensus;
+    BME688Sample out;
+
+    // Odd count: the middle value, and the far sensor is an outlier
+    BME688Sample odd[] = {sampleOf(2000), sampleOf(5000), sampleOf(2010)};
+    CHECK(consensus.update(odd, 3, out) == 0x02);
+    CHECK(out.temperature == 2010 && out.status == BME688_SAMPLE_TPH);
+    CHECK(consensus.residual(1, BME688_CHANNEL_TEMPERATURE) == 2990);
+    CHECK(consensus.residual(0, BME688_CHANNEL_TEMPERATURE) == -10);
+
+    // Even count: the mean of the two middle values
+    consensus.reset();
+    BME688Sample even[] = {sampleOf(2020), sampleOf(9000), sampleOf(2000), sampleOf(2010)};
+    CHECK(consensus.update(even, 4, out) == 0x02);
+    CHECK(out.temperature == 2015);
+}
+
+static void testTrimmedMean()
+{
+    BME688Consensus consensus(BME688_CONSENSUS_TRIMMED);
+    BME688Sample out;
+
+    // A quarter is dropped at each end: of five values, the three middle ones are averaged
+    BME688Sample five[] = {sampleOf(2090), sampleOf(2000), sampleOf(9000), sampleOf(2020), sampleOf(2010)};
+    consensus.update(five, 5, out);
+    CHECK(out.temperature == 2040);
+
+    // With two values nothing is dropped
+    consensus.reset();
+    BME688Sample two[] = {sampleOf(2000, 100000), sampleOf(2030, 100031)};
+    consensus.update(two, 2, out);
+    CHECK(out.temperature == 2015 && out.pressure == 100015);
+
+    // Of eight values, the four middle ones are averaged
+    consensus.reset();
+    BME688Sample eight[] = {sampleOf(2200), sampleOf(-500), sampleOf(2030), sampleOf(9000),
+                            sampleOf(2010), sampleOf(2100), sampleOf(2000), sampleOf(2020)};
+    consensus.update(eight, 8, out);
+    CHECK(out.temperature == 2040);
+
+    consensus.setMethod(BME688_CONSENSUS_MEDIAN);
+    consensus.update(five, 5, out);
+    CHECK(out.temperature == 2020);
+    consensus.update(eight, 8, out);
+    CHECK(out.temperature == 2025);
+}
+
+static void testQuarantine()
+{
+    BME688Consensus consensus;
+    BME688Sample samples[3] = {sampleOf(2000), sampleOf(2010), sampleOf(2005)}, out;
+
+    // A single glitch lowers the health but does not quarantine
+    samples[2].temperature = 2600;
+    CHECK(consensus.update(samples, 3, out) == 0x04);
+    CHECK(consensus.health(2) < BME688_HEALTH_MAX && consensus.health(2) >= BME688_HEALTH_QUARANTINE);
+    CHECK(!consensus.quarantined());
+    samples[2].temperature = 2005;
+    consensus.update(samples, 3, out);
+
+    // A drifting sensor is quarantined and left out of the consensus
+    int updates = 0;
+    samples[2].temperature = 2600;
+    while (!consensus.quarantined() && updates < 50)
+    {
+        consensus.update(samples, 3, out);
+        updates++;
+    }
+    CHECK(consensus.quarantined() == 0x04 && updates > 1 && updates < 10);
+    CHECK(consensus.health(2) < BME688_HEALTH_QUARANTINE);
+    CHECK(consensus.health(0) == BME688_HEALTH_MAX && consensus.health(1) == BME688_HEALTH_MAX);
+    consensus.update(samples, 3, out);
+    CHECK(out.temperature == 2005);
+
+    // After it recovers, it is only released above the release level (hysteresis)
+    samples[2].temperature = 2006;
+    updates = 0;
+    while (consensus.quarantined() && updates < 100)
+    {
+        CHECK(consensus.health(2) <= BME688_HEALTH_RELEASE);
+        CHECK(consensus.update(samples, 3, out) == 0);
+        updates++;
+    }
+    CHECK(!consensus.quarantined() && updates > 1 && updates < 100);
+    CHECK(consensus.health(2) > BME688_HEALTH_RELEASE);
+
+    // With every sensor quarantined, all of them are used so they can recover
+    BME688Sample split[2] = {sampleOf(2000), sampleOf(3000)};
+    consensus.reset();
+    for (int i = 0; i < 20; i++)
+        CHECK(consensus.update(split, 2, out) == 0x03);
+    CHECK(consensus.quarantined() == 0x03);
+    CHECK(out.temperature == 2500 && out.status == BME688_SAMPLE_TPH);
+}
+
+static void testMissingChannels()
+{
+    BME688Consensus consensus;
+    BME688Sample samples[3] = {sampleOf(2000), sampleOf(2010), sampleOf(2005)}, out;
+
+    // Gas is not checked by default, so sensors sampling gas on different cycles are not penalized
+    samples[0].status |= BME688_SAMPLE_GAS;
+    samples[0].gasResistance = 50000;
+    samples[0].gasIndex = 3;
+    for (int i = 0; i < 50; i++)
+        CHECK(consensus.update(samples, 3, out) == 0);
+    CHECK(consensus.health(1) == BME688_HEALTH_MAX && consensus.health(2) == BME688_HEALTH_MAX);
+    CHECK(out.gasResistance == 50000 && out.gasIndex == 3 && (out.status & BME688_SAMPLE_GAS));
+
+    // Once gas has a limit, a sensor missing it is an outlier
+    consensus.setLimit(BME688_CHANNEL_GAS, 1000);
+    CHECK(consensus.update(samples, 3, out) == 0x06);
+
+    // A checked channel missing from one sensor, or a failed read, counts against it
+    consensus.reset();
+    consensus.setLimit(BME688_CHANNEL_GAS, 0);
+    samples[1].status = BME688_SAMPLE_TEMPERATURE;
+    samples[2].status = 0;
+    CHECK(consensus.update(samples, 3, out) == 0x06);
+    CHECK(out.temperature == 2005);
+}
+
+int main()
+{
+    testMedian();
+    testTrimmedMean();
+    testQuarantine();
+    testMissingChannels();
+
+    printf("consensus: %s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/**
+ **************************************************
+ * @file        derived_benchmark.cpp
+ * @brief       Host benchmark of the exact and fast derived quantity
+ *              calculations (build with extras/host_tests.sh)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include "BME688-Derived.h"
+#include <chrono>
+
+#define BENCHMARK_RUNS 1000000 ///< Calls per timed calculation
+#define INPUT_COUNT    64      ///< Distinct inputs cycled through, so results can't be reused
+
+// Inputs are read through volatile and results go to a volatile sink, so the optimizer can
+// neither hoist the calls out of the loops nor drop them
+static volatile float temperatures[INPUT_COUNT], humidities[INPUT_COUNT], pressures[INPUT_COUNT];
+static volatile double sink;
+
+template <typename Function> static void run(const char *name, Function calculate)
+{
+    double sum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCHMARK_RUNS; i++)
+        sum += calculate(i % INPUT_COUNT);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    sink = sink + sum;
+    printf("%-22s %8.2f ns/call\n", name, elapsed.count() / BENCHMARK_RUNS);
+}
+
+static double dewPoint(long i)
+{
+    return BME688Derived::dewPoint(temperatures[i], humidities[i]);
+}
+
+static double dewPointFast(long i)
+{
+    return BME688Derived::dewPointFast(temperatures[i], humidities[i]);
+}
+
+static double absoluteHumidity(long i)
+{
+    return BME688Derived::absoluteHumidity(temperatures[i], humidities[i]);
+}
+
+static double absoluteHumidityFast(long i)
+{
+    return BME688Derived::absoluteHumidityFast(temperatures[i], humidities[i]);
+}
+
+static double altitude(long i)
+{
+    return BME688Derived::altitude(pressures[i]);
+}
+
+static double altitudeFast(long i)
+{
+    return BME688Derived::altitudeFast(pressures[i]);
+}
+
+int main()
+{
+    for (int i = 0; i < INPUT_COUNT; i++)
+    {
+        temperatures[i] = -40.0f + 125.0f * i / INPUT_COUNT;
+        humidities[i] = 1.0f + 99.0f * ((i * 37) % INPUT_COUNT) / INPUT_COUNT;
+        pressures[i] = 30000.0f + 80000.0f * ((i * 23) % INPUT_COUNT) / INPUT_COUNT;
+    }
+
+    run("dewPoint", dewPoint);
+    run("dewPointFast", dewPointFast);
+    run("absoluteHumidity", absoluteHumidity);
+    run("absoluteHumidityFast", absoluteHumidityFast);
+    run("altitude", altitude);
+    run("altitudeFast", altitudeFast);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ **************************************************
+ * @file        Arduino.h
+ * @brief       Minimal Arduino core for building the library on a desktop
+ *              host (used by the programs in /extras only)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_HOST_ARDUINO_H
+#define BME688_HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HIGH         1
+#define LOW          0
+#define INPUT_PULLUP 2
+#define OUTPUT       1
+
+// Flash strings are plain strings on the host
+class __FlashStringHelper;
+#define F(string) (reinterpret_cast<const __FlashStringHelper *>(string))
+
+class HostSerial
+{
+  public:
+    void begin(unsigned long)
+    {
+    }
+    void print(const __FlashStringHelper *text)
+    {
+        fputs((const char *)text, stderr);
+    }
+    void println(const __FlashStringHelper *text)
+    {
+        fprintf(stderr, "%s\n", (const char *)text);
+    }
+    operator bool()
+    {
+        return true;
+    }
+};
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+#endif // BME688_HOST_ARDUINO_H
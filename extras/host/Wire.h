@@ -0,0 +1,50 @@
+/**
+ **************************************************
+ * @file        Wire.h
+ * @brief       Simulated I2C bus with a BME688 register file for host builds
+ *              (used by the programs in /extras only)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_HOST_WIRE_H
+#define BME688_HOST_WIRE_H
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32 ///< Same receive buffer as the AVR core
+
+/**
+ * @class TwoWire
+ * @brief Register-file I2C target that answers like a BME688 with finished conversions.
+ *
+ * Every register read returns the register file. A write to ctrl_meas (0x74) copies results into
+ * field 0 and flags new data right away, so conversions complete instantly. Like the real sensor,
+ * a conversion reports 0x80000 (temperature, pressure) or 0x8000 (humidity) for skipped channels.
+ */
+class TwoWire
+{
+  public:
+    uint8_t regs[256];    ///< Register file of the simulated sensor
+    uint8_t results[17];  ///< Field 0 contents (0x1D - 0x2D) of the next conversion
+
+    TwoWire();
+    void begin();
+    void end();
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    uint8_t endTransmission(bool stop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t length);
+    int available();
+    int read();
+
+  private:
+    uint8_t pointer, received[BUFFER_LENGTH], length, position;
+    bool addressed;
+};
+
+extern TwoWire Wire;
+
+#endif // BME688_HOST_WIRE_H
@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# Host builds of the Soldered BME688 library.
+#
+# Compiles the library against the minimal Arduino core and simulated sensor in extras/host,
+# then runs:
+#   - derived_benchmark: time per call of the exact and fast derived quantities
+#   - compensation_benchmark: folded compensation against the Bosch double formulas, speed and difference
+#   - concurrency_stress: threads sharing one sensor object, under ThreadSanitizer, including reads of
+#     different channels whose conversions overlap
+#   - log_recovery_test: sample log on a file-backed block device, including power cuts
+#   - telemetry_test: packed, CBOR and delta stream round trips, including skipped channels
+#   - consensus_test: consensus of eight sensors with injected faulty streams
+#
+# Usage: extras/host_tests.sh
+#
+# Environment:
+#   CXX       Host C++ compiler (default: g++)
+#   BUILD_DIR Where binaries are kept (default: /tmp/bme688-host)
+
+CXX=${CXX:-g++}
+BUILD_DIR=${BUILD_DIR:-/tmp/bme688-host}
+
+LIBRARY=$(cd "$(dirname "$0")/.." && pwd)
+EXTRAS="$LIBRARY/extras"
+SOURCES="$EXTRAS/host/host.cpp $LIBRARY/src/*.cpp"
+FLAGS="-std=gnu++11 -I$EXTRAS/host -I$LIBRARY/src -DBME688_NO_LOGS"
+
+mkdir -p "$BUILD_DIR" || exit 1
+
+echo "== derived_benchmark (-O2)"
+$CXX $FLAGS -O2 -o "$BUILD_DIR/derived_benchmark" "$EXTRAS/derived_benchmark.cpp" $SOURCES -lpthread &&
+    "$BUILD_DIR/derived_benchmark" || exit 1
+
+echo "== compensation_benchmark (-O2)"
+$CXX $FLAGS -O2 -o "$BUILD_DIR/compensation_benchmark" "$EXTRAS/compensation_benchmark.cpp" $SOURCES -lpthread &&
+    "$BUILD_DIR/compensation_benchmark" || exit 1
+
+echo "== concurrency_stress (-fsanitize=thread)"
+$CXX $FLAGS -O1 -g -fsanitize=thread -o "$BUILD_DIR/concurrency_stress" "$EXTRAS/concurrency_stress.cpp" $SOURCES \
+    -lpthread && TSAN_OPTIONS="halt_on_error=1 ${TSAN_OPTIONS:-}" "$BUILD_DIR/concurrency_stress" || exit 1
+
+echo "== log_recovery_test"
+$CXX $FLAGS -O1 -g -fsanitize=address,undefined -o "$BUILD_DIR/log_recovery_test" "$EXTRAS/log_recovery_test.cpp" \
+    $SOURCES -lpthread && "$BUILD_DIR/log_recovery_test" "$BUILD_DIR/log.bin" || exit 1
+
+echo "== telemetry_test"
+$CXX $FLAGS -O1 -g -fsanitize=address,undefined -o "$BUILD_DIR/telemetry_test" "$EXTRAS/telemetry_test.cpp" $SOURCES \
+    -lpthread && "$BUILD_DIR/telemetry_test" || exit 1
+
+echo "== consensus_test"
+$CXX $FLAGS -DBME688_CONSENSUS_MAX=8 -O1 -g -fsanitize=address,undefined -o "$BUILD_DIR/consensus_test" \
+    "$EXTRAS/consensus_test.cpp" $SOURCES -lpthread && "$BUILD_DIR/consensus_test" || exit 1
@@ -0,0 +1,283 @@
+/**
+ **************************************************
+ * @file        log_recovery_test.cpp
+ * @brief       Host test of BME688Log on a file-backed block device: queries,
+ *              wrap-around and recovery after power cuts (build with
+ *              extras/host_tests.sh)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include "BME688-Log.h"
+#include <vector>
+
+#define TEST_PAGE_SIZE  128 ///< Page size of the test device (6 records per page)
+#define TEST_PAGE_COUNT 8   ///< Pages of the test device
+
+static unsigned failures = 0;
+
+#define CHECK(condition)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                              \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+/**
+ * @class FileBlockDevice
+ * @brief Block device in a file on Linux with NOR flash semantics.
+ *
+ * Programming can only clear bits, so the log writing a byte twice between erasures is caught.
+ * A write budget simulates a power cut: once it runs out, the operation in progress stops
+ * part-way and every later write fails until the budget is reset.
+ */
+class FileBlockDevice : public BME688BlockDevice
+{
+  public:
+    long budget;              ///< Bytes that may still be programmed, -1 for no limit
+    unsigned erases[TEST_PAGE_COUNT]; ///< Erase count per page
+
+    FileBlockDevice(const char *path) : budget(-1), path(path)
+    {
+        memset(erases, 0, sizeof(erases));
+        FILE *file = fopen(path, "wb");
+        std::vector<uint8_t> blank(TEST_PAGE_SIZE * TEST_PAGE_COUNT, 0xFF);
+        fwrite(&blank[0], 1, blank.size(), file);
+        fclose(file);
+    }
+
+    uint16_t pageSize()
+    {
+        return TEST_PAGE_SIZE;
+    }
+
+    uint32_t pageCount()
+    {
+        return TEST_PAGE_COUNT;
+    }
+
+    bool read(uint32_t page, uint16_t offset, void *data, uint16_t length)
+    {
+        FILE *file = fopen(path, "rb");
+        fseek(file, page * TEST_PAGE_SIZE + offset, SEEK_SET);
+        size_t count = fread(data, 1, length, file);
+        fclose(file);
+        return count == length;
+    }
+
+    bool program(uint32_t page, uint16_t offset, const void *data, uint16_t length)
+    {
+        std::vector<uint8_t> bytes(length);
+        const uint8_t *source = (const uint8_t *)data;
+        read(page, offset, &bytes[0], length);
+        for (uint16_t i = 0; i < length; i++)
+        {
+            if (!budget)
+            {
+                write(page, offset, &bytes[0], i);
+                return false;
+            }
+            if (budget > 0)
+                budget--;
+            CHECK((bytes[i] & source[i]) == source[i]);
+            bytes[i] &= source[i];
+        }
+        write(page, offset, &bytes[0], length);
+        return true;
+    }
+
+    bool erase(uint32_t page)
+    {
+        if (!budget)
+            return false;
+        std::vector<uint8_t> blank(TEST_PAGE_SIZE, 0xFF);
+        write(page, 0, &blank[0], blank.size());
+        erases[page]++;
+        return true;
+    }
+
+    // Overwrites bytes directly, bypassing the flash semantics (to inject corruption)
+    void write(uint32_t page, uint16_t offset, const uint8_t *data, size_t length)
+    {
+        FILE *file = fopen(path, "r+b");
+        fseek(file, page * TEST_PAGE_SIZE + offset, SEEK_SET);
+        fwrite(data, 1, length, file);
+        fclose(file);
+    }
+
+  private:
+    const char *path;
+};
+
+static BME688Sample sampleAt(uint32_t time)
+{
+    BME688Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.timestamp = time;
+    sample.temperature = 2000 + time % 500;
+    sample.pressure = 100000 + time;
+    sample.humidity = 4000;
+    sample.status = BME688_SAMPLE_TEMPERATURE | BME688_SAMPLE_PRESSURE | BME688_SAMPLE_HUMIDITY;
+    return sample;
+}
+
+static bool collect(const BME688Sample &sample, void *context)
+{
+    ((std::vector<uint32_t> *)context)->push_back(sample.timestamp);
+    return true;
+}
+
+static std::vector<uint32_t> dump(BME688Log &log)
+{
+    std::vector<uint32_t> times;
+    log.dump(collect, &times);
+    return times;
+}
+
+static bool ascending(const std::vector<uint32_t> &times)
+{
+    for (size_t i = 1; i < times.size(); i++)
+        if (times[i] <= times[i - 1])
+            return false;
+    return true;
+}
+
+static void testQueries(const char *path)
+{
+    FileBlockDevice device(path);
+    BME688Log log(device);
+    CHECK(log.begin());
+    CHECK(dump(log).empty());
+
+    for (uint32_t t = 0; t < 23; t++)
+        CHECK(log.append(sampleAt(t * 10)));
+    CHECK(log.usedPages() == 4);
+    CHECK(dump(log).size() == 23);
+    CHECK(!log.append(sampleAt(5))); // Time going backwards
+
+    std::vector<uint32_t> times;
+    CHECK(log.query(55, 120, collect, &times) == 7);
+    CHECK(times.front() == 60 && times.back() == 120);
+    times.clear();
+    CHECK(log.query(221, 1000, collect, &times) == 0);
+}
+
+static void testWrapAround(const char *path)
+{
+    FileBlockDevice device(path);
+    BME688Log log(device);
+    CHECK(log.begin());
+    for (uint32_t t = 0; t < 125; t++)
+        CHECK(log.append(sampleAt(t * 10)));
+
+    // The oldest pages were dropped, the newest samples are all there and in order
+    std::vector<uint32_t> times = dump(log);
+    CHECK(times.back() == 1240);
+    CHECK(ascending(times));
+    CHECK(times.size() > (TEST_PAGE_COUNT - 1) * 6);
+
+    std::vector<uint32_t> range;
+    CHECK(log.query(1000, 1050, collect, &range) == 6 && range.front() == 1000);
+
+    // Rotation spreads the erasures evenly
+    unsigned low = device.erases[0], high = device.erases[0];
+    for (int i = 1; i < TEST_PAGE_COUNT; i++)
+    {
+        low = device.erases[i] < low ? device.erases[i] : low;
+        high = device.erases[i] > high ? device.erases[i] : high;
+    }
+    CHECK(high - low <= 1);
+
+    // A remount finds the same samples
+    BME688Log remounted(device);
+    CHECK(remounted.begin());
+    CHECK(dump(remounted) == times);
+}
+
+static void testPowerCuts(const char *path)
+{
+    // Cut the power at every byte of an append that opens a new page, then mount again
+    for (long cut = 0; cut < BME688_LOG_HEADER_SIZE + BME688_LOG_RECORD_SIZE + 8; cut++)
+    {
+        FileBlockDevice device(path);
+        BME688Log log(device);
+        CHECK(log.begin());
+        for (uint32_t t = 0; t < 11; t++)
+            CHECK(log.append(sampleAt(t)));
+
+        device.budget = cut;
+        log.append(sampleAt(11));
+        log.append(sampleAt(12));
+        device.budget = -1;
+
+        BME688Log remounted(device);
+        CHECK(remounted.begin());
+        std::vector<uint32_t> times = dump(remounted);
+        CHECK(times.size() >= 11 && ascending(times));
+        CHECK(!remounted.append(sampleAt(5)));
+        CHECK(remounted.append(sampleAt(13)));
+        times = dump(remounted);
+        CHECK(times.back() == 13 && ascending(times));
+    }
+}
+
+static void testTornSeal(const char *path)
+{
+    // A seal cut after its last time field leaves a count but no valid CRC
+    FileBlockDevice device(path);
+    BME688Log log(device);
+    CHECK(log.begin());
+    for (uint32_t t = 0; t < 5; t++)
+        CHECK(log.append(sampleAt(t)));
+    device.budget = BME688_LOG_RECORD_SIZE + 5;
+    CHECK(log.append(sampleAt(5)));
+    device.budget = -1;
+
+    // Make the torn time field look like garbage far in the future
+    uint8_t garbage[4] = {0x00, 0x00, 0xFF, 0xFF};
+    device.write(0, 12, garbage, sizeof(garbage));
+
+    BME688Log remounted(device);
+    CHECK(remounted.begin());
+    CHECK(dump(remounted).size() == 6);
+    CHECK(remounted.append(sampleAt(6)));
+    CHECK(dump(remounted).back() == 6);
+}
+
+static void testCorruptRecord(const char *path)
+{
+    FileBlockDevice device(path);
+    BME688Log log(device);
+    CHECK(log.begin());
+    for (uint32_t t = 0; t < 10; t++)
+        CHECK(log.append(sampleAt(t)));
+
+    uint8_t byte;
+    device.read(0, BME688_LOG_HEADER_SIZE + BME688_LOG_RECORD_SIZE + 4, &byte, 1);
+    byte ^= 0x5A;
+    device.write(0, BME688_LOG_HEADER_SIZE + BME688_LOG_RECORD_SIZE + 4, &byte, 1);
+
+    BME688Log remounted(device);
+    CHECK(remounted.begin());
+    std::vector<uint32_t> times = dump(remounted);
+    CHECK(times.size() == 9 && times[1] == 2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "/tmp/bme688-log.bin";
+    testQueries(path);
+    testWrapAround(path);
+    testPowerCuts(path);
+    testTornSeal(path);
+    testCorruptRecord(path);
+    remove(path);
+
+    printf("log recovery: %s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
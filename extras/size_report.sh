@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# Size report for the Soldered BME688 library.
+#
+# Compiles every example with arduino-cli and prints, per example:
+#   - the total flash/RAM use of the sketch,
+#   - the size of each library object (one object per feature module),
+#   - the RAM taken by global BME688 objects.
+#
+# Usage: extras/size_report.sh [fqbn] [extra compiler flags]
+#   extras/size_report.sh                                  # Arduino Uno
+#   extras/size_report.sh arduino:avr:uno -DBME688_NO_LOGS # without log messages
+#
+# Environment:
+#   BUILD_DIR   Where builds are kept (default: /tmp/bme688-size)
+#   SIZE, NM    Binutils for the target (default: avr-size, avr-nm)
+#   RAM_LIMIT   Fail if data + bss of any example exceeds this many bytes
+#   FLASH_LIMIT Fail if text + data of any example exceeds this many bytes
+
+FQBN=${1:-arduino:avr:uno}
+FLAGS=${2:-}
+BUILD_DIR=${BUILD_DIR:-/tmp/bme688-size}
+SIZE=${SIZE:-avr-size}
+NM=${NM:-avr-nm}
+
+LIBRARY=$(cd "$(dirname "$0")/.." && pwd)
+STATUS=0
+
+for SKETCH in "$LIBRARY"/examples/*/; do
+    NAME=$(basename "$SKETCH")
+    OUT="$BUILD_DIR/$NAME"
+
+    if ! arduino-cli compile --fqbn "$FQBN" --library "$LIBRARY" --build-path "$OUT" \
+        --build-property "compiler.cpp.extra_flags=$FLAGS" --warnings none "$SKETCH" >/dev/null; then
+        echo "$NAME: compilation failed"
+        STATUS=1
+        continue
+    fi
+
+    ELF="$OUT/$NAME.ino.elf"
+    set -- $("$SIZE" "$ELF" | awk 'NR == 2 { print $1, $2, $3 }')
+    TEXT=$1
+    DATA=$2
+    BSS=$3
+
+    echo "== $NAME ($FQBN $FLAGS)"
+    echo "flash: $((TEXT + DATA)) bytes, RAM: $((DATA + BSS)) bytes"
+
+    echo "-- library objects"
+    "$SIZE" $(find "$OUT/libraries" -name 'BME688-*.o' | sort) | awk 'NR > 1 { n = split($6, path, "/"); printf "  %-28s text %6d  data %4d  bss %4d\n", path[n], $1, $2, $3 }'
+
+    echo "-- sensor objects in RAM"
+    "$NM" -S -C --size-sort "$ELF" | awk '$3 ~ /^[bBdD]$/ { print }' | while read -r ADDR LEN TYPE SYMBOL; do
+        case "$SYMBOL" in
+        sensor* | *BME688*) printf "  %-28s %6d bytes\n" "$SYMBOL" "$(printf '%d' "0x$LEN")" ;;
+        esac
+    done
+
+    if [ -n "$RAM_LIMIT" ] && [ $((DATA + BSS)) -gt "$RAM_LIMIT" ]; then
+        echo "$NAME: RAM use exceeds $RAM_LIMIT bytes"
+        STATUS=1
+    fi
+    if [ -n "$FLASH_LIMIT" ] && [ $((TEXT + DATA)) -gt "$FLASH_LIMIT" ]; then
+        echo "$NAME: flash use exceeds $FLASH_LIMIT bytes"
+        STATUS=1
+    fi
+done
+
+exit $STATUS
@@ -0,0 +1,218 @@
+/**
+ **************************************************
+ * @file        telemetry_test.cpp
+ * @brief       Host round-trip test of the packed, CBOR and delta stream
+ *              encoders (build with extras/host_tests.sh)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include "BME688-Telemetry.h"
+#include "Wire.h"
+
+static unsigned failures = 0;
+
+#define CHECK(condition)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                              \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+static BME688Sample makeSample(uint32_t timestamp, int16_t temperature, uint32_t pressure, uint16_t humidity,
+                               uint32_t gas, uint8_t gasIndex, uint8_t status)
+{
+    BME688Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.timestamp = timestamp;
+    sample.temperature = temperature;
+    sample.pressure = pressure;
+    sample.humidity = humidity;
+    sample.gasResistance = gas;
+    sample.gasIndex = gasIndex;
+    sample.status = status;
+    return sample;
+}
+
+// Compares the channels flagged in the status, plus the gas index when gas is flagged
+static bool sameChannels(const BME688Sample &a, const BME688Sample &b)
+{
+    return a.timestamp == b.timestamp && a.status == b.status &&
+           (!(a.status & BME688_SAMPLE_TEMPERATURE) || a.temperature == b.temperature) &&
+           (!(a.status & BME688_SAMPLE_PRESSURE) || a.pressure == b.pressure) &&
+           (!(a.status & BME688_SAMPLE_HUMIDITY) || a.humidity == b.humidity) &&
+           (!(a.status & BME688_SAMPLE_GAS) || (a.gasResistance == b.gasResistance && a.gasIndex == b.gasIndex));
+}
+
+// Samples at the edges of every field width and sign
+static const BME688Sample samples[] = {
+    makeSample(0, 0, 0, 0, 0, 0, 0),
+    makeSample(1000, 2150, 101325, 4500, 52000, 3, BME688_SAMPLE_ALL),
+    makeSample(1001, -1, 23, 24, 255, 9, BME688_SAMPLE_ALL),
+    makeSample(1002, -24, 256, 65535, 65536, 0, BME688_SAMPLE_ALL),
+    makeSample(1003, -25, 0xFFFFFF, 10000, 0xFFFFFFFF, 15, BME688_SAMPLE_ALL),
+    makeSample(0xFFFFFFFF, INT16_MIN, 30000, 0, 0x80000000, 1, BME688_SAMPLE_TPH),
+    makeSample(4, INT16_MAX, 110000, 9999, 1, 2, BME688_SAMPLE_ALL),
+    makeSample(5, -4000, 0, 0, 0, 0, BME688_SAMPLE_TEMPERATURE),
+    makeSample(6, 0, 0, 0, 70000, 4, BME688_SAMPLE_GAS),
+};
+#define SAMPLE_COUNT (sizeof(samples) / sizeof(samples[0]))
+
+static void testPacked()
+{
+    uint8_t buffer[BME688_PACKED_SIZE];
+    BME688Sample decoded;
+    for (size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        CHECK(BME688Telemetry::encodePacked(samples[i], buffer, sizeof(buffer)) == BME688_PACKED_SIZE);
+        CHECK(BME688Telemetry::decodePacked(buffer, sizeof(buffer), decoded) == BME688_PACKED_SIZE);
+        CHECK(sameChannels(samples[i], decoded));
+    }
+
+    // Pressure is stored in 24 bits and saturates
+    BME688Sample high = makeSample(1, 0, 0x1000000, 0, 0, 0, BME688_SAMPLE_PRESSURE);
+    BME688Telemetry::encodePacked(high, buffer, sizeof(buffer));
+    BME688Telemetry::decodePacked(buffer, sizeof(buffer), decoded);
+    CHECK(decoded.pressure == 0xFFFFFF);
+
+    CHECK(BME688Telemetry::encodePacked(samples[1], buffer, BME688_PACKED_SIZE - 1) == 0);
+    CHECK(BME688Telemetry::decodePacked(buffer, BME688_PACKED_SIZE - 1, decoded) == 0);
+}
+
+static void testCBOR()
+{
+    uint8_t buffer[BME688_CBOR_MAX_SIZE];
+    BME688Sample decoded;
+    for (size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        size_t length = BME688Telemetry::encodeCBOR(samples[i], buffer, sizeof(buffer));
+        CHECK(length > 0 && length <= BME688_CBOR_MAX_SIZE);
+        CHECK(BME688Telemetry::decodeCBOR(buffer, length, decoded) == length);
+        CHECK(sameChannels(samples[i], decoded));
+
+        // Every truncation is refused, on both ends
+        for (size_t size = 0; size < length; size++)
+        {
+            CHECK(BME688Telemetry::encodeCBOR(samples[i], buffer, size) == 0);
+            BME688Telemetry::encodeCBOR(samples[i], buffer, sizeof(buffer));
+            CHECK(BME688Telemetry::decodeCBOR(buffer, size, decoded) == 0);
+        }
+    }
+
+    // Channels missing from the status are left out of the map
+    size_t full = BME688Telemetry::encodeCBOR(samples[1], buffer, sizeof(buffer));
+    BME688Sample partial = samples[1];
+    partial.status = BME688_SAMPLE_TEMPERATURE;
+    CHECK(BME688Telemetry::encodeCBOR(partial, buffer, sizeof(buffer)) < full);
+    CHECK(buffer[0] == 0xA3);
+
+    // Anything but a small map is malformed
+    const uint8_t array[] = {0x83, 0x00, 0x00, 0x00};
+    CHECK(BME688Telemetry::decodeCBOR(array, sizeof(array), decoded) == 0);
+}
+
+static void testDelta()
+{
+    uint8_t buffer[BME688_DELTA_MAX_SIZE];
+    BME688DeltaEncoder encoder(4);
+    BME688DeltaDecoder decoder;
+    BME688Sample decoded, expected;
+    memset(&expected, 0, sizeof(expected));
+
+    // Two passes, so every transition between the edge samples is encoded, including wrap-around
+    for (size_t pass = 0; pass < 2 * SAMPLE_COUNT; pass++)
+    {
+        const BME688Sample &sample = samples[pass % SAMPLE_COUNT];
+        size_t length = encoder.encode(sample, buffer, sizeof(buffer));
+        CHECK(length > 0 && length <= BME688_DELTA_MAX_SIZE);
+        CHECK(((buffer[0] & BME688_DELTA_KEYFRAME) != 0) == (pass % 4 == 0));
+        CHECK(decoder.decode(buffer, length, decoded) == length);
+        CHECK(sameChannels(sample, decoded));
+
+        // Channels missing from a record keep their previous value, or 0 after a keyframe
+        if (buffer[0] & BME688_DELTA_KEYFRAME)
+            memset(&expected, 0, sizeof(expected));
+        expected.timestamp = sample.timestamp;
+        if (sample.status & BME688_SAMPLE_TEMPERATURE)
+            expected.temperature = sample.temperature;
+        if (sample.status & BME688_SAMPLE_PRESSURE)
+            expected.pressure = sample.pressure;
+        if (sample.status & BME688_SAMPLE_HUMIDITY)
+            expected.humidity = sample.humidity;
+        if (sample.status & BME688_SAMPLE_GAS)
+            expected.gasResistance = sample.gasResistance;
+        CHECK(decoded.temperature == expected.temperature && decoded.pressure == expected.pressure &&
+              decoded.humidity == expected.humidity && decoded.gasResistance == expected.gasResistance);
+    }
+
+    // A failed encode leaves the stream untouched
+    BME688DeltaEncoder small;
+    BME688DeltaDecoder fresh;
+    CHECK(small.encode(samples[4], buffer, 3) == 0);
+    size_t length = small.encode(samples[4], buffer, sizeof(buffer));
+    CHECK(buffer[0] & BME688_DELTA_KEYFRAME);
+
+    // A decoder joining mid-stream waits for a keyframe, and refuses truncated records
+    size_t next = small.encode(samples[1], buffer, sizeof(buffer));
+    CHECK(fresh.decode(buffer, next, decoded) == 0);
+    small.reset();
+    length = small.encode(samples[2], buffer, sizeof(buffer));
+    for (size_t size = 0; size < length; size++)
+        CHECK(fresh.decode(buffer, size, decoded) == 0);
+    CHECK(fresh.decode(buffer, length, decoded) == length && sameChannels(samples[2], decoded));
+}
+
+// Samples of conversions that skipped a channel: the sensor reports 0x80000 or 0x8000 for it, so it
+// must be absent from the sample status and from every encoding
+static void testSkippedChannels()
+{
+    const uint8_t field[] = {0x80, 0x00, 0x5A, 0x5A, 0x50, 0x80, 0x80, 0x10, 0x60, 0x00,
+                             0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x34};
+    memcpy(Wire.results, field, sizeof(field));
+    BME688 sensor;
+    CHECK(sensor.beginFast());
+    sensor.setChannels(BME688_SAMPLE_TEMPERATURE | BME688_SAMPLE_HUMIDITY);
+
+    BME688Sample sample, decoded;
+    CHECK(sensor.readSample(sample));
+    CHECK(sample.status == (BME688_SAMPLE_TEMPERATURE | BME688_SAMPLE_HUMIDITY));
+    CHECK(Wire.regs[0x1F] == 0x80 && Wire.regs[0x20] == 0x00);
+
+    uint8_t buffer[BME688_CBOR_MAX_SIZE];
+    BME688Telemetry::encodePacked(sample, buffer, sizeof(buffer));
+    BME688Telemetry::decodePacked(buffer, sizeof(buffer), decoded);
+    CHECK(sameChannels(sample, decoded) && !(decoded.status & BME688_SAMPLE_PRESSURE));
+
+    size_t length = BME688Telemetry::encodeCBOR(sample, buffer, sizeof(buffer));
+    CHECK(buffer[0] == 0xA4);
+    CHECK(BME688Telemetry::decodeCBOR(buffer, length, decoded) == length && sameChannels(sample, decoded));
+
+    BME688DeltaEncoder encoder;
+    BME688DeltaDecoder decoder;
+    length = encoder.encode(sample, buffer, sizeof(buffer));
+    CHECK(decoder.decode(buffer, length, decoded) == length && sameChannels(sample, decoded));
+
+    // Skipped humidity reads 0x8000
+    sensor.setChannels(BME688_SAMPLE_TEMPERATURE | BME688_SAMPLE_PRESSURE);
+    CHECK(sensor.readSample(sample));
+    CHECK(sample.status == (BME688_SAMPLE_TEMPERATURE | BME688_SAMPLE_PRESSURE));
+    CHECK(Wire.regs[0x25] == 0x80 && Wire.regs[0x26] == 0x00);
+    length = encoder.encode(sample, buffer, sizeof(buffer));
+    CHECK(decoder.decode(buffer, length, decoded) == length && sameChannels(sample, decoded));
+}
+
+int main()
+{
+    testPacked();
+    testCBOR();
+    testDelta();
+    testSkippedChannels();
+
+    printf("telemetry: %s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,318 @@
+/**
+ **************************************************
+ *
+ * @file        BME688-Consensus.cpp
+ * @brief       Consensus of redundant BME688 sensors with outlier
+ *              quarantine and per-sensor health scores
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include <BME688-Consensus.h>
+
+/**
+ * @brief Constructor for the consensus
+ *
+ * @param method BME688_CONSENSUS_MEDIAN or BME688_CONSENSUS_TRIMMED
+ */
+BME688Consensus::BME688Consensus(uint8_t method)
+    : method(method), rate(BME688_HEALTH_RATE), quarantineLevel(BME688_HEALTH_QUARANTINE),
+      releaseLevel(BME688_HEALTH_RELEASE)
+{
+    limits[BME688_CHANNEL_TEMPERATURE] = 100;
+    limits[BME688_CHANNEL_PRESSURE] = 100;
+    limits[BME688_CHANNEL_HUMIDITY] = 500;
+    limits[BME688_CHANNEL_GAS] = 0;
+    reset();
+}
+
+/**
+ * @brief Set how channel values are combined
+ *
+ * @param method BME688_CONSENSUS_MEDIAN or BME688_CONSENSUS_TRIMMED
+ */
+void BME688Consensus::setMethod(uint8_t method)
+{
+    this->method = method;
+}
+
+/**
+ * @brief Set the residual limit of a channel
+ *
+ * @param channel Channel index
+ * @param limit Limit in sample units, 0 to disable the check
+ */
+void BME688Consensus::setLimit(uint8_t channel, uint32_t limit)
+{
+    if (channel < BME688_CHANNEL_COUNT)
+        limits[channel] = limit;
+}
+
+/**
+ * @brief Set the health smoothing
+ *
+ * @param rate Smoothing shift (1 to 7)
+ */
+void BME688Consensus::setHealthRate(uint8_t rate)
+{
+    this->rate = rate < 1 ? 1 : rate > 7 ? 7 : rate;
+}
+
+/**
+ * @brief Set the quarantine hysteresis
+ *
+ * @param quarantine Health below which a sensor is quarantined
+ * @param release Health above which a sensor is released
+ */
+void BME688Consensus::setQuarantineLevels(uint8_t quarantine, uint8_t release)
+{
+    quarantineLevel = quarantine;
+    releaseLevel = release < quarantine ? quarantine : release;
+}
+
+/**
+ * @brief Mark every sensor healthy
+ */
+void BME688Consensus::reset()
+{
+    memset(residuals, 0, sizeof(residuals));
+    memset(scores, BME688_HEALTH_MAX, sizeof(scores));
+    quarantine = lastOutliers = 0;
+}
+
+/**
+ * @brief Combine one sample from each sensor
+ *
+ * @param samples One sample per sensor
+ * @param count Number of samples
+ * @param out Consensus sample
+ * @return uint8_t Bit mask of the outlier sensors
+ */
+uint8_t BME688Consensus::update(const BME688Sample *samples, uint8_t count, BME688Sample &out)
+{
+    if (count > BME688_CONSENSUS_MAX)
+        count = BME688_CONSENSUS_MAX;
+    memset(&out, 0, sizeof(out));
+    memset(residuals, 0, sizeof(residuals));
+
+    uint8_t outliers = 0;
+    for (uint8_t channel = 0; channel < BME688_CHANNEL_COUNT; channel++)
+    {
+        uint8_t flag = 1 << channel;
+        int32_t values[BME688_CONSENSUS_MAX], all[BME688_CONSENSUS_MAX];
+        uint8_t healthy = 0, reported = 0;
+
+        for (uint8_t i = 0; i < count; i++)
+        {
+            const BME688Sample &s = samples[i];
+            if (!(s.status & flag))
+                continue;
+            int32_t value = channel == BME688_CHANNEL_TEMPERATURE ? s.temperature
+                            : channel == BME688_CHANNEL_PRESSURE  ? (int32_t)s.pressure
+                            : channel == BME688_CHANNEL_HUMIDITY  ? s.humidity
+                            : s.gasResistance > 0x7FFFFFFF        ? 0x7FFFFFFF
+                                                                  : (int32_t)s.gasResistance;
+            all[reported++] = value;
+            if (!(quarantine & (1 << i)))
+                values[healthy++] = value;
+        }
+        if (!reported)
+            continue;
+
+        // With every reporting sensor quarantined, fall back to all of them so they can recover
+        if (!healthy)
+        {
+            memcpy(values, all, reported * sizeof(int32_t));
+            healthy = reported;
+        }
+        int32_t consensus = combine(values, healthy);
+
+        for (uint8_t i = 0, n = 0; i < count; i++)
+        {
+            // A missing channel only counts against a sensor when the channel is checked
+            if (!(samples[i].status & flag))
+            {
+                if (limits[channel])
+                    outliers |= 1 << i;
+                continue;
+            }
+            int64_t diff = (int64_t)all[n++] - consensus;
+            residuals[i][channel] = diff > INT32_MAX ? INT32_MAX : diff < INT32_MIN ? INT32_MIN : (int32_t)diff;
+            if (limits[channel] && (diff > (int64_t)limits[channel] || -diff > (int64_t)limits[channel]))
+                outliers |= 1 << i;
+        }
+
+        out.status |= flag;
+        switch (channel)
+        {
+        case BME688_CHANNEL_TEMPERATURE:
+            out.temperature = consensus;
+            break;
+        case BME688_CHANNEL_PRESSURE:
+            out.pressure = consensus;
+            break;
+        case BME688_CHANNEL_HUMIDITY:
+            out.humidity = consensus;
+            break;
+        default:
+            out.gasResistance = consensus;
+            break;
+        }
+    }
+
+    // Move every health score towards its target and apply the quarantine hysteresis
+    bool timeSet = false, gasIndexSet = false;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t bit = 1 << i;
+        int16_t diff = (outliers & bit ? 0 : BME688_HEALTH_MAX) - scores[i];
+        int16_t step = diff >> rate;
+        if (!step)
+            step = diff > 0 ? 1 : diff < 0 ? -1 : 0;
+        scores[i] += step;
+
+        if (scores[i] < quarantineLevel)
+            quarantine |= bit;
+        else if (scores[i] > releaseLevel)
+            quarantine &= ~bit;
+
+        if (samples[i].status && (!timeSet || (int32_t)(samples[i].timestamp - out.timestamp) > 0))
+        {
+            out.timestamp = samples[i].timestamp;
+            timeSet = true;
+        }
+        if (!gasIndexSet && (samples[i].status & BME688_SAMPLE_GAS))
+        {
+            out.gasIndex = samples[i].gasIndex;
+            gasIndexSet = true;
+        }
+    }
+    lastOutliers = outliers;
+    return outliers;
+}
+
+/**
+ * @brief Combine the values of one channel
+ *
+ * @param values Values, reordered in place
+ * @param count Number of values (at least 1)
+ * @return int32_t Median or trimmed mean
+ */
+int32_t BME688Consensus::combine(int32_t *values, uint8_t count) const
+{
+    if (method == BME688_CONSENSUS_TRIMMED)
+    {
+        // Partition off a quarter at each end, then average the middle
+        uint8_t trim = (count + 1) / 4;
+        select(values, count, trim);
+        select(values + trim, count - trim, count - 2 * trim - 1);
+        int64_t sum = 0;
+        for (uint8_t i = trim; i < count - trim; i++)
+            sum += values[i];
+        return sum / (count - 2 * trim);
+    }
+
+    // select() leaves the larger values after the lower middle one, so the upper middle is their minimum
+    uint8_t mid = (count - 1) / 2;
+    int32_t lower = select(values, count, mid);
+    if (count & 1)
+        return lower;
+    int32_t upper = values[mid + 1];
+    for (uint8_t i = mid + 2; i < count; i++)
+        if (values[i] < upper)
+            upper = values[i];
+    return ((int64_t)lower + upper) / 2;
+}
+
+/**
+ * @brief Find the k-th smallest value (quickselect)
+ *
+ * Reorders the values so that the ones before index k are not larger and the ones after it are
+ * not smaller.
+ *
+ * @param values Values, reordered in place
+ * @param count Number of values
+ * @param k Rank to find, 0 for the smallest
+ * @return int32_t The k-th smallest value
+ */
+int32_t BME688Consensus::select(int32_t *values, uint8_t count, uint8_t k)
+{
+    uint8_t left = 0, right = count - 1;
+    while (left < right)
+    {
+        int32_t pivot = values[(left + right) / 2];
+        uint8_t i = left, j = right;
+        while (i <= j)
+        {
+            while (values[i] < pivot)
+                i++;
+            while (values[j] > pivot)
+                j--;
+            if (i <= j)
+            {
+                int32_t swap = values[i];
+                values[i] = values[j];
+                values[j] = swap;
+                i++;
+                if (!j)
+                    break;
+                j--;
+            }
+        }
+        if (k <= j)
+            right = j;
+        else if (k >= i)
+            left = i;
+        else
+            break;
+    }
+    return values[k];
+}
+
+/**
+ * @brief Get the health score of a sensor
+ *
+ * @param sensor Sensor index
+ * @return uint8_t Health, 0 for an unknown sensor
+ */
+uint8_t BME688Consensus::health(uint8_t sensor) const
+{
+    return sensor < BME688_CONSENSUS_MAX ? scores[sensor] : 0;
+}
+
+/**
+ * @brief Get the last residual of a sensor channel
+ *
+ * @param sensor Sensor index
+ * @param channel Channel index
+ * @return int32_t Residual in sample units
+ */
+int32_t BME688Consensus::residual(uint8_t sensor, uint8_t channel) const
+{
+    if (sensor >= BME688_CONSENSUS_MAX || channel >= BME688_CHANNEL_COUNT)
+        return 0;
+    return residuals[sensor][channel];
+}
+
+/**
+ * @brief Get the quarantined sensors
+ *
+ * @return uint8_t Bit mask of sensor indexes
+ */
+uint8_t BME688Consensus::quarantined() const
+{
+    return quarantine;
+}
+
+/**
+ * @brief Get the outliers of the last update
+ *
+ * @return uint8_t Bit mask of sensor indexes
+ */
+uint8_t BME688Consensus::outliers() const
+{
+    return lastOutliers;
+}
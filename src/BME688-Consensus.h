@@ -0,0 +1,141 @@
+/**
+ **************************************************
+ * @file        BME688-Consensus.h
+ * @brief       Consensus of redundant BME688 sensors with outlier
+ *              quarantine and per-sensor health scores
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_CONSENSUS_H
+#define BME688_CONSENSUS_H
+
+#include "BME688-Soldered.h"
+
+#ifdef __cplusplus
+
+// Consensus Settings
+#ifndef BME688_CONSENSUS_MAX
+#define BME688_CONSENSUS_MAX 4 ///< Most sensors in one consensus, at most 8
+#endif
+#define BME688_CONSENSUS_MEDIAN  0   ///< Consensus is the median of the healthy sensors
+#define BME688_CONSENSUS_TRIMMED 1   ///< Consensus is the mean after dropping a quarter of the values at each end
+#define BME688_HEALTH_MAX        255 ///< Health of a sensor that agrees with the consensus
+#define BME688_HEALTH_RATE       3   ///< Default health smoothing, each sample moves the health 1/8 of the way
+#define BME688_HEALTH_QUARANTINE 96  ///< Default health below which a sensor is quarantined
+#define BME688_HEALTH_RELEASE    192 ///< Default health above which a quarantined sensor is released
+
+/**
+ * @class BME688Consensus
+ * @brief Combines time-aligned samples of several sensors into one sample per update.
+ *
+ * For every channel, the consensus is taken over the sensors that are not quarantined (or over
+ * all sensors when every one of them is). Every sensor is then compared with the consensus: a
+ * residual beyond the channel limit, or a channel the others reported but the sensor did not,
+ * makes the sample an outlier. Channels whose limit is 0 are not checked either way. The health
+ * score of a sensor is an exponential moving average of its good (BME688_HEALTH_MAX) and
+ * outlier (0) samples, so a single glitch does not quarantine it. A quarantined sensor keeps
+ * being scored and is released once its health recovers.
+ *
+ * Memory is fixed by BME688_CONSENSUS_MAX, and an update costs O(N) per channel.
+ */
+class BME688Consensus
+{
+  public:
+    /**
+     * @brief Creates a consensus with every sensor healthy.
+     * @param method BME688_CONSENSUS_MEDIAN or BME688_CONSENSUS_TRIMMED.
+     */
+    BME688Consensus(uint8_t method = BME688_CONSENSUS_MEDIAN);
+
+    /**
+     * @brief Sets how the values of a channel are combined.
+     * @param method BME688_CONSENSUS_MEDIAN or BME688_CONSENSUS_TRIMMED.
+     */
+    void setMethod(uint8_t method);
+
+    /**
+     * @brief Sets the largest residual of a channel that still agrees with the consensus.
+     *
+     * Defaults are 1 °C, 100 Pa and 5 %RH. Gas resistance differs widely between sensors, so
+     * its limit is disabled by default.
+     * @param channel Channel index (BME688_CHANNEL_*).
+     * @param limit Limit in sample units (0 = not checked, and a sensor missing the channel is not
+     *              an outlier).
+     */
+    void setLimit(uint8_t channel, uint32_t limit);
+
+    /**
+     * @brief Sets how quickly health scores follow the samples.
+     * @param rate Each sample moves the health 1 / 2^rate of the way to its target (1 to 7).
+     */
+    void setHealthRate(uint8_t rate);
+
+    /**
+     * @brief Sets the quarantine hysteresis.
+     * @param quarantine Health below which a sensor is quarantined.
+     * @param release Health above which a quarantined sensor is released.
+     */
+    void setQuarantineLevels(uint8_t quarantine, uint8_t release);
+
+    /**
+     * @brief Combines one sample from each sensor.
+     *
+     * The output holds the channels that at least one sensor reported, the newest timestamp and
+     * the gas index of the first sensor reporting gas. Pass a sample with status 0 for a sensor
+     * whose read failed, so the sensor indexes stay aligned.
+     * @param samples One sample per sensor, in the same order on every update.
+     * @param count Number of samples (at most BME688_CONSENSUS_MAX are used).
+     * @param out Consensus sample.
+     * @return Bit mask of the sensors whose sample was an outlier.
+     */
+    uint8_t update(const BME688Sample *samples, uint8_t count, BME688Sample &out);
+
+    /**
+     * @brief Returns the health score of a sensor.
+     * @param sensor Sensor index.
+     * @return Health from 0 to BME688_HEALTH_MAX.
+     */
+    uint8_t health(uint8_t sensor) const;
+
+    /**
+     * @brief Returns the last residual of a sensor channel.
+     * @param sensor Sensor index.
+     * @param channel Channel index (BME688_CHANNEL_*).
+     * @return Sensor value minus consensus in sample units, 0 if the channel was not reported.
+     */
+    int32_t residual(uint8_t sensor, uint8_t channel) const;
+
+    /**
+     * @brief Returns the quarantined sensors.
+     * @return Bit mask of sensor indexes.
+     */
+    uint8_t quarantined() const;
+
+    /**
+     * @brief Returns the outliers of the last update.
+     * @return Bit mask of sensor indexes.
+     */
+    uint8_t outliers() const;
+
+    /**
+     * @brief Marks every sensor healthy and clears the residuals.
+     */
+    void reset();
+
+  private:
+    uint32_t limits[BME688_CHANNEL_COUNT];
+    int32_t residuals[BME688_CONSENSUS_MAX][BME688_CHANNEL_COUNT];
+    uint8_t scores[BME688_CONSENSUS_MAX];
+    uint8_t method, rate, quarantineLevel, releaseLevel;
+    uint8_t quarantine = 0, lastOutliers = 0;
+
+    int32_t combine(int32_t *values, uint8_t count) const;
+    static int32_t select(int32_t *values, uint8_t count, uint8_t k);
+};
+
+#endif // __cplusplus
+#endif // BME688_CONSENSUS_H
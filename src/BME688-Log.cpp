@@ -0,0 +1,424 @@
+/**
+ **************************************************
+ *
+ * @file        BME688-Log.cpp
+ * @brief       Append-only BME688 sample log with a sparse time index on an
+ *              abstract block device (SPI flash, SD card, EEPROM)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include <BME688-Log.h>
+
+// Page header fields (little-endian)
+#define BME688_LOG_MAGIC_OFFSET 0  ///< Magic (4 bytes), programmed when the page is opened
+#define BME688_LOG_SEQ_OFFSET   4  ///< Sequence number (4 bytes), programmed when the page is opened
+#define BME688_LOG_FIRST_OFFSET 8  ///< First timestamp (4 bytes), programmed when the page is opened
+#define BME688_LOG_SEAL_OFFSET  12 ///< Last timestamp (4), record count (2) and CRC-16 (2), programmed when sealed
+#define BME688_LOG_COUNT_OFFSET 16 ///< Record count of a sealed page, 0xFFFF while the page is open
+#define BME688_LOG_CRC_OFFSET   18 ///< CRC-16 of the first 18 header bytes
+
+/**
+ * @brief Write a 32-bit value in little-endian order
+ */
+static void putLE32(uint8_t *out, uint32_t value)
+{
+    for (uint8_t i = 0; i < 4; i++)
+        out[i] = value >> (8 * i);
+}
+
+/**
+ * @brief Read a 32-bit value in little-endian order
+ */
+static uint32_t getLE32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+/**
+ * @brief Constructor for the sample log
+ *
+ * @param device Storage to use
+ */
+BME688Log::BME688Log(BME688BlockDevice &device) : device(device)
+{
+}
+
+/**
+ * @brief Mount the log
+ *
+ * @return true if the device is usable
+ */
+bool BME688Log::begin()
+{
+    mounted = false;
+    pages = device.pageCount();
+    uint16_t size = device.pageSize();
+    if (pages < 2 || size < BME688_LOG_HEADER_SIZE + BME688_LOG_RECORD_SIZE)
+        return false;
+    slots = (size - BME688_LOG_HEADER_SIZE) / BME688_LOG_RECORD_SIZE;
+
+    // The page with the lowest sequence number is the oldest, the highest is the newest
+    uint32_t lowest = 0xFFFFFFFF, highest = 0;
+    oldest = 0;
+    used = 0;
+    for (uint32_t page = 0; page < pages; page++)
+    {
+        uint32_t seq, first;
+        if (!readHeader(page, &seq, &first))
+            continue;
+        used++;
+        if (seq < lowest)
+        {
+            lowest = seq;
+            oldest = page;
+        }
+        if (seq >= highest)
+            highest = seq;
+    }
+    sequence = highest;
+    nextSlot = pageRecords = 0;
+    lastTime = 0;
+
+    if (used)
+    {
+        // Recover the newest page: a sealed page with a valid header CRC is full, any other page
+        // (open, or with a seal torn by power loss) is scanned for its first free slot
+        uint32_t page = newest();
+        uint8_t header[BME688_LOG_HEADER_SIZE];
+        if (!device.read(page, 0, header, sizeof(header)))
+            return false;
+        uint16_t count = header[BME688_LOG_COUNT_OFFSET] | header[BME688_LOG_COUNT_OFFSET + 1] << 8;
+        uint16_t crc = header[BME688_LOG_CRC_OFFSET] | header[BME688_LOG_CRC_OFFSET + 1] << 8;
+        if (count != 0xFFFF && crc == crc16(header, BME688_LOG_CRC_OFFSET))
+        {
+            lastTime = getLE32(header + BME688_LOG_SEAL_OFFSET);
+            pageRecords = count;
+            nextSlot = slots;
+        }
+        else
+        {
+            // The first time was programmed when the page was opened, so samples older than it
+            // stay rejected even if power was lost before the first record landed
+            lastTime = getLE32(header + BME688_LOG_FIRST_OFFSET);
+            BME688Sample sample;
+            bool erased = false;
+            for (; nextSlot < slots; nextSlot++)
+            {
+                if (readRecord(page, nextSlot, sample, &erased))
+                {
+                    lastTime = sample.timestamp;
+                    pageRecords++;
+                }
+                else if (erased)
+                    break;
+            }
+        }
+    }
+    mounted = true;
+    return true;
+}
+
+/**
+ * @brief Erase every page of the log
+ *
+ * @return true on success
+ */
+bool BME688Log::format()
+{
+    pages = device.pageCount();
+    for (uint32_t page = 0; page < pages; page++)
+        if (!device.erase(page))
+            return false;
+    return begin();
+}
+
+/**
+ * @brief Append a sample
+ *
+ * @param sample Sample to store
+ * @return true if the sample was stored
+ */
+bool BME688Log::append(const BME688Sample &sample)
+{
+    if (!mounted || (used && sample.timestamp < lastTime))
+        return false;
+
+    if (!used || nextSlot >= slots)
+    {
+        // A page that filled up before power was lost may still be open
+        if (used && !sealPage())
+            return false;
+        if (!openPage(sample.timestamp))
+            return false;
+    }
+
+    uint8_t record[BME688_LOG_RECORD_SIZE];
+    BME688Telemetry::encodePacked(sample, record, BME688_PACKED_SIZE);
+    record[BME688_PACKED_SIZE] = crc8(record, BME688_PACKED_SIZE);
+
+    // A failed write may have left the slot half programmed, so it is never reused
+    uint16_t slot = nextSlot++;
+    if (!device.program(newest(), BME688_LOG_HEADER_SIZE + slot * BME688_LOG_RECORD_SIZE, record, sizeof(record)))
+        return false;
+    pageRecords++;
+    lastTime = sample.timestamp;
+
+    if (nextSlot >= slots)
+        sealPage();
+    return true;
+}
+
+/**
+ * @brief Read every stored sample, oldest first
+ *
+ * @param callback Called for each sample
+ * @param context Passed to the callback
+ * @return uint32_t Number of samples passed to the callback
+ */
+uint32_t BME688Log::dump(BME688LogCallback callback, void *context)
+{
+    return scan(0, 0, 0xFFFFFFFF, callback, context);
+}
+
+/**
+ * @brief Read the samples in a time range, oldest first
+ *
+ * @param from First timestamp
+ * @param to Last timestamp
+ * @param callback Called for each sample
+ * @param context Passed to the callback
+ * @return uint32_t Number of samples passed to the callback
+ */
+uint32_t BME688Log::query(uint32_t from, uint32_t to, BME688LogCallback callback, void *context)
+{
+    if (!mounted || !used || from > to)
+        return 0;
+
+    // Binary search the page headers for the last page starting at or before 'from'
+    uint32_t low = 0, high = used - 1;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low + 1) / 2, seq, first;
+        if (readHeader(physical(mid), &seq, &first) && first <= from)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    return scan(low, from, to, callback, context);
+}
+
+/**
+ * @brief Get the number of pages holding samples
+ *
+ * @return uint32_t Page count
+ */
+uint32_t BME688Log::usedPages()
+{
+    return used;
+}
+
+/**
+ * @brief Get the physical page of the newest log page
+ *
+ * @return uint32_t Page number
+ */
+uint32_t BME688Log::newest()
+{
+    return used ? physical(used - 1) : BME688_LOG_PAGE_UNKNOWN;
+}
+
+/**
+ * @brief Map a log page index (0 = oldest) to a physical page
+ *
+ * @param index Log page index
+ * @return uint32_t Page number
+ */
+uint32_t BME688Log::physical(uint32_t index)
+{
+    return (oldest + index) % pages;
+}
+
+/**
+ * @brief Read the part of a page header written when the page was opened
+ *
+ * @param page Physical page
+ * @param sequence Sequence number
+ * @param firstTime Timestamp of the first record
+ * @return true if the page belongs to the log
+ */
+bool BME688Log::readHeader(uint32_t page, uint32_t *sequence, uint32_t *firstTime)
+{
+    uint8_t header[BME688_LOG_SEAL_OFFSET];
+    if (!device.read(page, 0, header, sizeof(header)) || getLE32(header + BME688_LOG_MAGIC_OFFSET) != BME688_LOG_MAGIC)
+        return false;
+    *sequence = getLE32(header + BME688_LOG_SEQ_OFFSET);
+    *firstTime = getLE32(header + BME688_LOG_FIRST_OFFSET);
+    return true;
+}
+
+/**
+ * @brief Read and verify one record
+ *
+ * @param page Physical page
+ * @param slot Record slot
+ * @param sample Decoded sample
+ * @param erased Set if the slot was never written
+ * @return true if the record is valid
+ */
+bool BME688Log::readRecord(uint32_t page, uint16_t slot, BME688Sample &sample, bool *erased)
+{
+    uint8_t record[BME688_LOG_RECORD_SIZE];
+    *erased = false;
+    if (!device.read(page, BME688_LOG_HEADER_SIZE + slot * BME688_LOG_RECORD_SIZE, record, sizeof(record)))
+        return false;
+
+    *erased = true;
+    for (uint8_t i = 0; i < sizeof(record); i++)
+        if (record[i] != 0xFF)
+            *erased = false;
+    if (*erased || crc8(record, BME688_PACKED_SIZE) != record[BME688_PACKED_SIZE])
+        return false;
+    return BME688Telemetry::decodePacked(record, BME688_PACKED_SIZE, sample) == BME688_PACKED_SIZE;
+}
+
+/**
+ * @brief Start a new page after the newest one, dropping the oldest page if the device is full
+ *
+ * @param firstTime Timestamp of the first record
+ * @return true on success
+ */
+bool BME688Log::openPage(uint32_t firstTime)
+{
+    uint32_t page = used ? (newest() + 1) % pages : oldest;
+    if (used == pages)
+    {
+        oldest = (oldest + 1) % pages;
+        used--;
+    }
+
+    uint8_t header[BME688_LOG_SEAL_OFFSET];
+    putLE32(header + BME688_LOG_MAGIC_OFFSET, BME688_LOG_MAGIC);
+    putLE32(header + BME688_LOG_SEQ_OFFSET, sequence + 1);
+    putLE32(header + BME688_LOG_FIRST_OFFSET, firstTime);
+    // The magic goes last, so a page torn while opening is not taken for part of the log
+    if (!device.erase(page) ||
+        !device.program(page, BME688_LOG_SEQ_OFFSET, header + BME688_LOG_SEQ_OFFSET,
+                        sizeof(header) - BME688_LOG_SEQ_OFFSET) ||
+        !device.program(page, BME688_LOG_MAGIC_OFFSET, header, BME688_LOG_SEQ_OFFSET))
+        return false;
+
+    if (!used)
+        oldest = page;
+    sequence++;
+    used++;
+    nextSlot = pageRecords = 0;
+    return true;
+}
+
+/**
+ * @brief Complete the header of the newest page with its last time, count and CRC
+ *
+ * @return true if the page is sealed
+ */
+bool BME688Log::sealPage()
+{
+    uint32_t page = newest();
+    uint8_t header[BME688_LOG_HEADER_SIZE];
+    if (!device.read(page, 0, header, sizeof(header)))
+        return false;
+    if ((header[BME688_LOG_COUNT_OFFSET] & header[BME688_LOG_COUNT_OFFSET + 1]) != 0xFF)
+        return true;
+
+    putLE32(header + BME688_LOG_SEAL_OFFSET, lastTime);
+    header[BME688_LOG_COUNT_OFFSET] = pageRecords;
+    header[BME688_LOG_COUNT_OFFSET + 1] = pageRecords >> 8;
+    uint16_t crc = crc16(header, BME688_LOG_CRC_OFFSET);
+    header[BME688_LOG_CRC_OFFSET] = crc;
+    header[BME688_LOG_CRC_OFFSET + 1] = crc >> 8;
+    return device.program(page, BME688_LOG_SEAL_OFFSET, header + BME688_LOG_SEAL_OFFSET,
+                          BME688_LOG_HEADER_SIZE - BME688_LOG_SEAL_OFFSET);
+}
+
+/**
+ * @brief Pass the records in a time range to a callback, starting at a log page
+ *
+ * @param index First log page to read
+ * @param from First timestamp
+ * @param to Last timestamp
+ * @param callback Called for each sample
+ * @param context Passed to the callback
+ * @return uint32_t Number of samples passed to the callback
+ */
+uint32_t BME688Log::scan(uint32_t index, uint32_t from, uint32_t to, BME688LogCallback callback, void *context)
+{
+    uint32_t count = 0;
+    if (!mounted || !callback)
+        return 0;
+
+    for (; index < used; index++)
+    {
+        uint32_t page = physical(index);
+        uint16_t end = index == used - 1 ? nextSlot : slots;
+        for (uint16_t slot = 0; slot < end; slot++)
+        {
+            BME688Sample sample;
+            bool erased;
+            if (!readRecord(page, slot, sample, &erased))
+            {
+                if (erased)
+                    break;
+                continue;
+            }
+            if (sample.timestamp < from)
+                continue;
+            if (sample.timestamp > to)
+                return count;
+            count++;
+            if (!callback(sample, context))
+                return count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief CRC-8 of a record (polynomial 0x31, initial value 0xFF)
+ *
+ * @param data Data to check
+ * @param length Length in bytes
+ * @return uint8_t CRC
+ */
+uint8_t BME688Log::crc8(const uint8_t *data, uint16_t length)
+{
+    uint8_t crc = 0xFF;
+    while (length--)
+    {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief CRC-16/CCITT of a page header (polynomial 0x1021, initial value 0xFFFF)
+ *
+ * @param data Data to check
+ * @param length Length in bytes
+ * @return uint16_t CRC
+ */
+uint16_t BME688Log::crc16(const uint8_t *data, uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+    while (length--)
+    {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
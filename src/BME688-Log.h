@@ -0,0 +1,168 @@
+/**
+ **************************************************
+ * @file        BME688-Log.h
+ * @brief       Append-only BME688 sample log with a sparse time index on an
+ *              abstract block device (SPI flash, SD card, EEPROM)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_LOG_H
+#define BME688_LOG_H
+
+#include "BME688-Soldered.h"
+#include "BME688-Telemetry.h"
+
+#ifdef __cplusplus
+
+// Page Layout
+#define BME688_LOG_MAGIC        0x4C383842 ///< Marks a page that belongs to the log ("B88L")
+#define BME688_LOG_HEADER_SIZE  20         ///< Page header: magic, sequence, first time, last time, count, CRC
+#define BME688_LOG_RECORD_SIZE  (BME688_PACKED_SIZE + 1) ///< Packed sample followed by its CRC-8
+#define BME688_LOG_PAGE_UNKNOWN 0xFFFFFFFF ///< No page
+
+/**
+ * @class BME688BlockDevice
+ * @brief Storage interface used by BME688Log.
+ *
+ * A page is the unit of erasure (e.g. a 4 KB sector of SPI NOR flash, or a block of a file on
+ * an SD card). Erased bytes read as 0xFF, and the log programs every byte at most once
+ * between erasures, so the interface maps directly onto NOR flash.
+ */
+class BME688BlockDevice
+{
+  public:
+    virtual ~BME688BlockDevice()
+    {
+    }
+
+    /**
+     * @brief Returns the page size.
+     * @return Page size in bytes, at least BME688_LOG_HEADER_SIZE + BME688_LOG_RECORD_SIZE.
+     */
+    virtual uint16_t pageSize() = 0;
+
+    /**
+     * @brief Returns the number of pages the log may use.
+     * @return Page count, at least 2.
+     */
+    virtual uint32_t pageCount() = 0;
+
+    /**
+     * @brief Reads bytes from a page.
+     * @return True on success.
+     */
+    virtual bool read(uint32_t page, uint16_t offset, void *data, uint16_t length) = 0;
+
+    /**
+     * @brief Programs erased bytes of a page.
+     * @return True on success.
+     */
+    virtual bool program(uint32_t page, uint16_t offset, const void *data, uint16_t length) = 0;
+
+    /**
+     * @brief Erases a page to 0xFF.
+     * @return True on success.
+     */
+    virtual bool erase(uint32_t page) = 0;
+};
+
+/**
+ * @brief Called for every sample returned by BME688Log::dump() and BME688Log::query().
+ * @return True to continue, false to stop.
+ */
+typedef bool (*BME688LogCallback)(const BME688Sample &sample, void *context);
+
+/**
+ * @class BME688Log
+ * @brief Circular append-only log of packed samples.
+ *
+ * Every page starts with a header holding its sequence number and the time of its first sample,
+ * followed by fixed-size records protected by a CRC-8. The header is completed with the last
+ * time, record count and a CRC when the page fills up. Pages are used in a ring, so every page is
+ * erased equally often, and the oldest page is dropped when the device is full.
+ *
+ * The first times of the pages form a sparse time index: a time query binary searches the page
+ * headers and then reads records from one page onwards. This needs sample timestamps that never
+ * go backwards, so set BME688Sample::timestamp from an RTC when the log must survive resets.
+ */
+class BME688Log
+{
+  public:
+    /**
+     * @brief Creates a log on a block device.
+     * @param device Storage to use.
+     */
+    BME688Log(BME688BlockDevice &device);
+
+    /**
+     * @brief Mounts the log, finding the newest page and recovering an interrupted page.
+     * @return True if the device is usable.
+     */
+    bool begin();
+
+    /**
+     * @brief Erases every page of the log.
+     * @return True on success.
+     */
+    bool format();
+
+    /**
+     * @brief Appends a sample.
+     * @param sample Sample to store. Its timestamp must not be older than the previous one.
+     * @return True if the sample was stored.
+     */
+    bool append(const BME688Sample &sample);
+
+    /**
+     * @brief Reads every stored sample, oldest first.
+     * @param callback Called for each sample.
+     * @param context Passed to the callback.
+     * @return Number of samples passed to the callback.
+     */
+    uint32_t dump(BME688LogCallback callback, void *context = NULL);
+
+    /**
+     * @brief Reads the samples with from <= timestamp <= to, oldest first.
+     * @param from First timestamp.
+     * @param to Last timestamp.
+     * @param callback Called for each sample.
+     * @param context Passed to the callback.
+     * @return Number of samples passed to the callback.
+     */
+    uint32_t query(uint32_t from, uint32_t to, BME688LogCallback callback, void *context = NULL);
+
+    /**
+     * @brief Returns the number of pages holding samples.
+     * @return Page count.
+     */
+    uint32_t usedPages();
+
+  private:
+    BME688BlockDevice &device;
+    uint32_t pages = 0;        // Pages on the device
+    uint32_t oldest = 0;       // Physical page of the oldest log page
+    uint32_t used = 0;         // Pages holding samples
+    uint32_t sequence = 0;     // Sequence number of the newest page
+    uint32_t lastTime = 0;     // Timestamp of the newest record
+    uint16_t slots = 0;        // Records per page
+    uint16_t nextSlot = 0;     // Next free record slot in the newest page
+    uint16_t pageRecords = 0;  // Valid records in the newest page
+    bool mounted = false;
+
+    uint32_t newest();
+    uint32_t physical(uint32_t index);
+    bool readHeader(uint32_t page, uint32_t *sequence, uint32_t *firstTime);
+    bool readRecord(uint32_t page, uint16_t slot, BME688Sample &sample, bool *erased);
+    bool openPage(uint32_t firstTime);
+    bool sealPage();
+    uint32_t scan(uint32_t index, uint32_t from, uint32_t to, BME688LogCallback callback, void *context);
+    static uint8_t crc8(const uint8_t *data, uint16_t length);
+    static uint16_t crc16(const uint8_t *data, uint16_t length);
+};
+
+#endif // __cplusplus
+#endif // BME688_LOG_H
@@ -12,14 +12,25 @@
  ***************************************************/
 
 #include <BME688-Soldered.h>
+#include <BME688-Statistics.h>
+#include <BME688-Triggers.h>
 #include <Wire.h>
 
+// Log messages are passed as flash strings, or compiled out with BME688_NO_LOGS
+#ifdef BME688_NO_LOGS
+#define BME688_LOG(message) ((void)0)
+#else
+#define BME688_LOG(message) printLog(F(message))
+#endif
+
 /**
  * @brief Constructor for BME688 sensor interface
  *
  * @param address I2C address of the sensor
  */
-BME688::BME688(uint8_t address) : _address(address)
+BME688::BME688(uint8_t address)
+    : _address(address), printLogs(false), autoRecovery(false), recovering(false), allowHighTemps(false),
+      calibLoaded(false), heaterReady(false), subMeasValid(false)
 {
 }
 
@@ -30,17 +41,19 @@ BME688::BME688(uint8_t address) : _address(address)
  */
 bool BME688::begin()
 {
-    Wire.begin();
-    if (isConnected())
+    startBus();
+    bool connected = isConnected();
+    if (connected)
     {
         i2c_execute(BME_688_CTRL_MEAS_HUM_REG, hum_oss);
         i2c_execute(BME_688_CTRL_MEAS_REG, temp_oss << 5 | press_oss << 2 | BME_688_FORCED_MODE);
         i2c_execute(BME_688_IIR_FILTER_REG, BME_688_IIR_FILTER_C15);
         readCalibParams();
+        setHeatProfiles();
     }
     else
-        printLog(BME_688_CHECK_CONN_ERR);
-    return isConnected();
+        BME688_LOG(BME_688_CHECK_CONN_ERR);
+    return connected;
 }
 
 /**
@@ -51,25 +64,7 @@ bool BME688::begin()
  */
 bool BME688::begin(uint8_t mode)
 {
-    Wire.begin();
-    if (isConnected())
-    {
-        if (mode <= BME_688_PARALLEL_MODE)
-        {
-            i2c_execute(BME_688_CTRL_MEAS_HUM_REG, BME_688_OSS_1);
-            i2c_execute(BME_688_CTRL_MEAS_REG, BME_688_OSS_1 << 5 | BME_688_OSS_1 << 2 | mode);
-            i2c_execute(BME_688_IIR_FILTER_REG, BME_688_IIR_FILTER_C15);
-            readCalibParams();
-        }
-        else
-        {
-            printLog(BME_688_VALUE_INVALID);
-            return false;
-        }
-    }
-    else
-        printLog(BME_688_CHECK_CONN_ERR);
-    return isConnected();
+    return begin(mode, BME_688_OSS_1);
 }
 
 /**
@@ -81,25 +76,61 @@ bool BME688::begin(uint8_t mode)
  */
 bool BME688::begin(uint8_t mode, uint8_t oss)
 {
-    Wire.begin();
-    if (isConnected())
+    if (mode > BME_688_PARALLEL_MODE || oss > BME_688_OSS_16)
     {
-        if (mode <= BME_688_PARALLEL_MODE && oss <= BME_688_OSS_16)
-        {
-            i2c_execute(BME_688_CTRL_MEAS_HUM_REG, oss);
-            i2c_execute(BME_688_CTRL_MEAS_REG, oss << 5 | oss << 2 | mode);
-            i2c_execute(BME_688_IIR_FILTER_REG, BME_688_IIR_FILTER_C15);
-            readCalibParams();
-        }
-        else
-        {
-            printLog(BME_688_VALUE_INVALID);
-            return false;
-        }
+        BME688_LOG(BME_688_VALUE_INVALID);
+        return false;
+    }
+
+    startBus();
+    bool connected = isConnected();
+    if (connected)
+    {
+        lock();
+        this->mode = mode;
+        temp_oss = press_oss = hum_oss = oss;
+        unlock();
+        i2c_execute(BME_688_CTRL_MEAS_HUM_REG, oss);
+        i2c_execute(BME_688_CTRL_MEAS_REG, oss << 5 | oss << 2 | mode);
+        i2c_execute(BME_688_IIR_FILTER_REG, BME_688_IIR_FILTER_C15);
+        readCalibParams();
+        setHeatProfiles();
+    }
+    else
+        BME688_LOG(BME_688_CHECK_CONN_ERR);
+    return connected;
+}
+
+/**
+ * @brief Initialize the sensor with the shortest possible start-up
+ *
+ * Only probes the chip ID, writes the measurement configuration and turns the
+ * gas conversion off. Calibration is read on the first measurement and the heater profiles are programmed on the
+ * first gas request.
+ *
+ * @return true if the sensor responded, false otherwise
+ */
+bool BME688::beginFast()
+{
+    startBus();
+    bool connected = isConnected();
+    if (connected)
+    {
+        uint8_t ctrl_hum, ctrl_meas;
+        lock();
+        calibLoaded = false;
+        heaterReady = false;
+        unlock();
+        readConfig(&ctrl_hum, &ctrl_meas);
+        i2c_execute(BME_688_CTRL_MEAS_HUM_REG, ctrl_hum);
+        i2c_execute(BME_688_CTRL_MEAS_REG, ctrl_meas & ~BME_688_MODE_MASK);
+        i2c_execute(BME_688_IIR_FILTER_REG, BME_688_IIR_FILTER_C15);
+        // A warm restart (MCU reset without a power cycle) can leave run_gas set
+        i2c_execute(BME_688_CTRL_GAS_REG, 0x00);
     }
     else
-        printLog(BME_688_CHECK_CONN_ERR);
-    return isConnected();
+        BME688_LOG(BME_688_CHECK_CONN_ERR);
+    return connected;
 }
 
 /**
@@ -107,9 +138,12 @@ bool BME688::begin(uint8_t mode, uint8_t oss)
  *
  * @param log Message to print
  */
-void BME688::printLog(String log)
+void BME688::printLog(const __FlashStringHelper *log)
 {
-    if (printLogs)
+    lock();
+    bool show = printLogs;
+    unlock();
+    if (show)
         Serial.println(log);
 }
 
@@ -120,49 +154,245 @@ void BME688::printLog(String log)
  */
 void BME688::showLogs(bool show)
 {
+    lock();
     printLogs = show;
+    unlock();
+}
+
+/**
+ * @brief Set the hooks that serialize access to the bus and shared state
+ *
+ * @param lockBus Called before each I2C transaction and state access
+ * @param unlockBus Called right after it
+ * @param context Passed to both hooks
+ */
+void BME688::setBusLock(BME688LockCallback lockBus, BME688LockCallback unlockBus, void *context)
+{
+    lockCallback = lockBus;
+    unlockCallback = unlockBus;
+    lockContext = context;
+}
+
+/**
+ * @brief Take the bus/state lock if hooks are set
+ */
+void BME688::lock()
+{
+    if (lockCallback)
+        lockCallback(lockContext);
+}
+
+/**
+ * @brief Release the bus/state lock if hooks are set
+ */
+void BME688::unlock()
+{
+    if (unlockCallback)
+        unlockCallback(lockContext);
+}
+
+/**
+ * @brief Take a consistent copy of the measurement configuration
+ *
+ * Channels that are not requested or not enabled are skipped (BME_688_OSS_NONE).
+ *
+ * @param ctrl_hum Humidity control register value
+ * @param ctrl_meas Measurement control register value
+ * @param channels BME688_SAMPLE_* flags of the channels to convert
+ * @return uint8_t BME688_SAMPLE_* flags of the channels that will be converted
+ */
+uint8_t BME688::readConfig(uint8_t *ctrl_hum, uint8_t *ctrl_meas, uint8_t channels)
+{
+    lock();
+    channels &= enabledChannels;
+    // Pressure and humidity compensation need the temperature of the same conversion
+    if (channels & (BME688_SAMPLE_PRESSURE | BME688_SAMPLE_HUMIDITY))
+        channels |= BME688_SAMPLE_TEMPERATURE;
+    uint8_t t = channels & BME688_SAMPLE_TEMPERATURE ? temp_oss : BME_688_OSS_NONE;
+    uint8_t p = channels & BME688_SAMPLE_PRESSURE ? press_oss : BME_688_OSS_NONE;
+    uint8_t h = channels & BME688_SAMPLE_HUMIDITY ? hum_oss : BME_688_OSS_NONE;
+    *ctrl_hum = h;
+    *ctrl_meas = t << 5 | p << 2 | mode;
+    unlock();
+
+    if (!t)
+        channels &= ~BME688_SAMPLE_TEMPERATURE;
+    if (!p)
+        channels &= ~BME688_SAMPLE_PRESSURE;
+    if (!h)
+        channels &= ~BME688_SAMPLE_HUMIDITY;
+    return channels;
+}
+
+/**
+ * @brief Calculate the duration of a forced conversion (Bosch BME68x formula)
+ *
+ * @param ctrl_hum Humidity control register value
+ * @param ctrl_meas Measurement control register value
+ * @return uint32_t Conversion time in µs, without the heater phase
+ */
+uint32_t BME688::conversionTime(uint8_t ctrl_hum, uint8_t ctrl_meas)
+{
+    // Measurement cycles per oversampling setting (skipped, 1x, 2x, 4x, 8x, 16x)
+    static const uint8_t cycles[] = {0, 1, 2, 4, 8, 16};
+    uint8_t oss[3] = {(uint8_t)(ctrl_meas >> 5), (uint8_t)(ctrl_meas >> 2 & 0x07), (uint8_t)(ctrl_hum & 0x07)};
+    uint32_t duration = 0;
+    for (uint8_t i = 0; i < 3; i++)
+        duration += cycles[oss[i] > BME_688_OSS_16 ? BME_688_OSS_16 : oss[i]];
+    duration = duration * BME_688_MEAS_CYCLE_TIME + BME_688_TPH_SWITCH_TIME + BME_688_GAS_MEAS_TIME;
+    if ((ctrl_meas & BME_688_MODE_MASK) != BME_688_PARALLEL_MODE)
+        duration += BME_688_WAKE_UP_TIME;
+    return duration;
+}
+
+/**
+ * @brief Start a conversion of the requested channels and wait until it is done
+ *
+ * @param channels BME688_SAMPLE_* flags of the channels to convert
+ * @param heaterTime Heater duration in ms (0 without a gas reading)
+ * @return uint8_t BME688_SAMPLE_* flags of the converted channels
+ */
+uint8_t BME688::convert(uint8_t channels, uint16_t heaterTime)
+{
+    uint8_t ctrl_hum, ctrl_meas;
+    channels = readConfig(&ctrl_hum, &ctrl_meas, channels);
+    if (!channels)
+        return 0;
+
+    // Without a heater time the heater must stay off, or the conversion would outlast the wait.
+    // beginFast() already turned it off, so ctrl_gas is only rewritten once a gas request has set it.
+    if (!heaterTime)
+    {
+        lock();
+        bool ready = heaterReady;
+        unlock();
+        if (ready)
+            i2c_execute(BME_688_CTRL_GAS_REG, 0x00);
+    }
+    i2c_execute(BME_688_CTRL_MEAS_HUM_REG, ctrl_hum);
+    i2c_execute(BME_688_CTRL_MEAS_REG, ctrl_meas);
+    uint32_t wait = conversionTime(ctrl_hum, ctrl_meas) + heaterTime * 1000UL;
+    delay(wait / 1000);
+    delayMicroseconds(wait % 1000);
+    return channels;
+}
+
+/**
+ * @brief Store the ambient temperature used for heater resistance calculation
+ *
+ * @param t_fine Fine temperature from readUCTemp()
+ */
+void BME688::updateAmbient(float t_fine)
+{
+    float t = t_fine / 5120.0f;
+    lock();
+    ambTemp = (int8_t)(t < -128.0f ? -128.0f : (t > 127.0f ? 127.0f : t));
+    unlock();
+}
+
+/**
+ * @brief Get the tuned heater duration of a profile
+ *
+ * @param profile Profile number (0-9)
+ * @return uint16_t Tuned duration in ms, 0 if not tuned
+ */
+uint16_t BME688::tunedDuration(uint8_t profile)
+{
+    lock();
+    uint16_t duration = heatDuration[profile];
+    unlock();
+    return duration;
 }
 
 /**
  * @brief Read calibration parameters from sensor registers
+ *
+ * Reads both calibration blocks and the heater calibration in three bursts.
+ *
+ * @return true if all calibration data was read
+ */
+bool BME688::readCalibParams()
+{
+    uint8_t coeff1[BME_688_CALIB1_LENGTH], coeff2[BME_688_CALIB2_LENGTH], heat[BME_688_CALIB3_LENGTH];
+
+    // Temperature and pressure calibration parameters (0x8A - 0xA0)
+    if (!i2c_readByte(BME_688_CALIB1_REG, coeff1, BME_688_CALIB1_LENGTH))
+    {
+        BME688_LOG(BME_688_PRES_CAL_EXCEPT);
+        return false;
+    }
+
+    // Humidity, temperature and gas calibration parameters (0xE1 - 0xEE)
+    if (!i2c_readByte(BME_688_CALIB2_REG, coeff2, BME_688_CALIB2_LENGTH))
+    {
+        BME688_LOG(BME_688_HUM_CAL_EXCEPT);
+        return false;
+    }
+
+    // Heater resistance calibration (0x00 - 0x02)
+    if (!i2c_readByte(BME_688_CALIB3_REG, heat, BME_688_CALIB3_LENGTH))
+    {
+        BME688_LOG(BME_688_TEMP_CAL_EXCEPT);
+        return false;
+    }
+
+    Calibration calib;
+    calib.par_t1 = coeff2[9] << 8 | coeff2[8];
+    calib.par_t2 = coeff1[1] << 8 | coeff1[0];
+    calib.par_t3 = coeff1[2];
+
+    calib.par_p1 = coeff1[5] << 8 | coeff1[4];
+    calib.par_p2 = coeff1[7] << 8 | coeff1[6];
+    calib.par_p3 = coeff1[8];
+    calib.par_p4 = coeff1[11] << 8 | coeff1[10];
+    calib.par_p5 = coeff1[13] << 8 | coeff1[12];
+    calib.par_p6 = coeff1[15];
+    calib.par_p7 = coeff1[14];
+    calib.par_p8 = coeff1[19] << 8 | coeff1[18];
+    calib.par_p9 = coeff1[21] << 8 | coeff1[20];
+    calib.par_p10 = coeff1[22];
+
+    calib.par_h1 = coeff2[2] << 4 | (coeff2[1] & 0x0F);
+    calib.par_h2 = coeff2[0] << 4 | coeff2[1] >> 4;
+    calib.par_h3 = coeff2[3];
+    calib.par_h4 = coeff2[4];
+    calib.par_h5 = coeff2[5];
+    calib.par_h6 = coeff2[6];
+    calib.par_h7 = coeff2[7];
+
+    calib.par_g2 = coeff2[11] << 8 | coeff2[10];
+    calib.par_g1 = coeff2[12];
+    calib.par_g3 = coeff2[13];
+    calib.res_heat_val = heat[0];
+    calib.res_heat_range = heat[2];
+    foldCalibration(calib);
+    return true;
+}
+
+/**
+ * @brief Read calibration on first use after beginFast()
+ *
+ * @return true if calibration is available
+ */
+bool BME688::ensureCalibration()
+{
+    lock();
+    bool loaded = calibLoaded;
+    unlock();
+    return loaded || readCalibParams();
+}
+
+/**
+ * @brief Program the heater profiles on the first gas request after beginFast()
+ *
+ * @return true if the heater profiles are programmed
  */
-void BME688::readCalibParams()
-{
-    // Read temperature calibration parameters
-    if (!(i2c_read_Xbit_LE(BME_688_TEMP_CALIB1_REG, &par_t16[0], 16) &&
-          i2c_read_Xbit_LE(BME_688_TEMP_CALIB2_REG, &par_t16[1], 16) &&
-          i2c_readByte(BME_688_TEMP_CALIB3_REG, &par_t3, 1)))
-        printLog(BME_688_TEMP_CAL_EXCEPT);
-
-    // Read pressure calibration parameters
-    if (!(i2c_read_Xbit_LE(BME_688_PRES_CALIB1_REG, &par_p1, 16) &&
-          i2c_read_Xbit_LE(BME_688_PRES_CALIB2_REG, &par_p16[1], 16) &&
-          i2c_readByte(BME_688_PRES_CALIB3_REG, &par_p8[0], 1) &&
-          i2c_read_Xbit_LE(BME_688_PRES_CALIB4_REG, &par_p16[2], 16) &&
-          i2c_read_Xbit_LE(BME_688_PRES_CALIB5_REG, &par_p16[3], 16) &&
-          i2c_readByte(BME_688_PRES_CALIB6_REG, &par_p8[1], 1) &&
-          i2c_readByte(BME_688_PRES_CALIB7_REG, &par_p8[2], 1) &&
-          i2c_read_Xbit_LE(BME_688_PRES_CALIB8_REG, &par_p16[4], 16) &&
-          i2c_read_Xbit_LE(BME_688_PRES_CALIB9_REG, &par_p16[5], 16) &&
-          i2c_readByte(BME_688_PRES_CALIB10_REG, &par_p10, 1)))
-        printLog(BME_688_PRES_CAL_EXCEPT);
-
-    // Read humidity calibration parameters
-    if (!(i2c_read_Xbit_LE(BME_688_HUM_CALIB1_REG, &par_h16[0], 12) &&
-          i2c_read_Xbit(BME_688_HUM_CALIB2_REG, &par_h16[1], 12) &&
-          i2c_readByte(BME_688_HUM_CALIB3_REG, &par_h8[0], 1) && i2c_readByte(BME_688_HUM_CALIB4_REG, &par_h8[1], 1) &&
-          i2c_readByte(BME_688_HUM_CALIB5_REG, &par_h8[2], 1) && i2c_readByte(BME_688_HUM_CALIB6_REG, &par_h6, 1) &&
-          i2c_readByte(BME_688_HUM_CALIB7_REG, &par_h8[4], 1)))
-        printLog(BME_688_HUM_CAL_EXCEPT);
-
-    // Read gas calibration parameters
-    if (!(i2c_readByte(BME_688_GAS_CALIB1_REG, &par_g1, 1) && i2c_read_Xbit_LE(BME_688_GAS_CALIB2_REG, &par_g2, 16) &&
-          i2c_readByte(BME_688_GAS_CALIB3_REG, &par_g3, 1) &&
-          i2c_readByte(BME_688_GAS_HEAT_RANGE_REG, &res_heat_range, 1) &&
-          i2c_readByte(BME_688_GAS_HEAT_VAL_REG, &res_heat_val, 1)))
-        printLog(BME_688_TEMP_CAL_EXCEPT);
-
-    setHeatProfiles();
+bool BME688::ensureHeater()
+{
+    lock();
+    bool ready = heaterReady;
+    unlock();
+    return ready || (ensureCalibration() && setHeatProfiles());
 }
 
 /**
@@ -172,14 +402,233 @@ void BME688::readCalibParams()
  */
 bool BME688::setHeatProfiles()
 {
+    Coefficients k;
     readTemperature();
-    for (uint8_t i = 0; i < 9; i++)
+    loadCoefficients(k);
+    for (uint8_t i = 0; i < BME_688_GAS_PROFILE_COUNT; i++)
     {
         yield();
-        uint8_t gasTemp = readUCGas(BME_688_GAS_START_TEMP + i * 25);
-        i2c_execute(BME_688_GAS_WAIT_PROFILE_REG + i, BME_688_GAS_WAIT_MULFAC1 << 6 | (uint8_t)(0.25 * gasTemp - 22));
+        uint8_t gasTemp = readUCGas(k, BME_688_GAS_START_TEMP + i * 25);
+        uint16_t duration = tunedDuration(i);
+        if (duration)
+            i2c_execute(BME_688_GAS_WAIT_PROFILE_REG + i, encodeGasWait(duration));
+        else
+            i2c_execute(BME_688_GAS_WAIT_PROFILE_REG + i,
+                        BME_688_GAS_WAIT_MULFAC1 << 6 | (uint8_t)(0.25 * gasTemp - 22));
         i2c_execute(BME_688_GAS_RES_HEAT_PROFILE_REG + i, gasTemp);
     }
+    lock();
+    heaterReady = true;
+    unlock();
+    return true;
+}
+
+/**
+ * @brief Encode a heater duration into the gas_wait register format
+ *
+ * Picks the smallest multiplication factor (1, 4, 16, 64) that fits the duration into
+ * the 6-bit value field, rounding up so the plate never gets less time than requested.
+ *
+ * @param duration Heater duration in ms
+ * @return uint8_t gas_wait register value
+ */
+uint8_t BME688::encodeGasWait(uint16_t duration)
+{
+    if (duration >= BME_688_GAS_WAIT_MAX)
+        return BME_688_GAS_WAIT_MULFAC4 << 6 | BME_688_GAS_WAIT_VAL_MASK;
+
+    uint8_t mulfac = BME_688_GAS_WAIT_MULFAC1;
+    uint16_t factor = 1;
+    while ((duration + factor - 1) / factor > BME_688_GAS_WAIT_VAL_MASK)
+    {
+        mulfac++;
+        factor <<= 2;
+    }
+    return mulfac << 6 | (uint8_t)((duration + factor - 1) / factor);
+}
+
+/**
+ * @brief Decode a gas_wait register value into a heater duration
+ *
+ * @param code gas_wait register value
+ * @return uint16_t Heater duration in ms
+ */
+uint16_t BME688::decodeGasWait(uint8_t code)
+{
+    return (uint16_t)(code & BME_688_GAS_WAIT_VAL_MASK) << (2 * (code >> 6));
+}
+
+/**
+ * @brief Run one heater tuning trial for a profile
+ *
+ * @param profile Profile number (0-9)
+ * @param duration Heater duration to try in ms
+ * @return true if BME_688_GAS_TUNE_CONFIRM consecutive measurements reached heater stability
+ */
+bool BME688::runHeaterTrial(uint8_t profile, uint16_t duration)
+{
+    uint8_t code = encodeGasWait(duration);
+    i2c_execute(BME_688_GAS_WAIT_PROFILE_REG + profile, code);
+    for (uint8_t i = 0; i < BME_688_GAS_TUNE_CONFIRM; i++)
+    {
+        delay(BME_688_GAS_TUNE_COOLDOWN);
+        if (!runGasConversion(profile, decodeGasWait(code) + BME_688_GAS_READOUT_MARGIN) ||
+            !checkGasMeasurementCompletion())
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Start a gas-only forced conversion and wait until its result is in field 0
+ *
+ * Temperature, pressure and humidity are skipped, so the conversion is the heater phase plus
+ * the fixed gas measurement time.
+ *
+ * @param profile Profile number (0-9)
+ * @param heaterTime Heater duration in ms
+ * @return true if the conversion finished
+ */
+bool BME688::runGasConversion(uint8_t profile, uint16_t heaterTime)
+{
+    uint8_t ctrl_hum, ctrl_meas;
+    readConfig(&ctrl_hum, &ctrl_meas, 0);
+    i2c_execute(BME_688_CTRL_MEAS_HUM_REG, ctrl_hum);
+    i2c_execute(BME_688_CTRL_GAS_REG, BME_688_GAS_RUN | profile);
+    i2c_execute(BME_688_CTRL_MEAS_REG, ctrl_meas);
+    return waitForData(conversionTime(ctrl_hum, ctrl_meas) + heaterTime * 1000UL);
+}
+
+/**
+ * @brief Wait for a forced conversion to finish
+ *
+ * Sleeps for the expected duration, then polls field 0 until new data is flagged and no
+ * measurement is running, so the status bits read next belong to this conversion.
+ *
+ * @param wait Expected duration in µs
+ * @return true if the conversion finished
+ */
+bool BME688::waitForData(uint32_t wait)
+{
+    delay(wait / 1000);
+    delayMicroseconds(wait % 1000);
+    for (uint8_t i = 0; i < BME_688_POLL_RETRIES; i++)
+    {
+        uint8_t status = 0;
+        if (i2c_readByte(BME_688_FIELD0_REG, &status, 1) && (status & BME_688_GAS_NEW_DATA_MASK) &&
+            !(status & (BME_688_GAS_MEAS_MASK | BME_688_MEAS_MASK)))
+            return true;
+        delay(BME_688_POLL_INTERVAL);
+    }
+    return false;
+}
+
+/**
+ * @brief Find and store the shortest reliable heater duration for a profile
+ *
+ * @param profile Profile number (0-9)
+ * @return true if a duration was found
+ */
+bool BME688::tuneHeaterDuration(uint8_t profile)
+{
+    if (profile >= BME_688_GAS_PROFILE_COUNT)
+    {
+        BME688_LOG(BME_688_PROFILE_OUT_OF_RANGE);
+        return false;
+    }
+    if (!ensureHeater())
+        return false;
+
+    // Grow the duration until the heater stabilises, then bisect between the last failure and the first success
+    uint16_t low = 0, high = BME_688_GAS_TUNE_START;
+    while (!runHeaterTrial(profile, high))
+    {
+        low = high;
+        if (high >= BME_688_GAS_WAIT_MAX)
+        {
+            high = 0;
+            break;
+        }
+        high = high * 2 > BME_688_GAS_WAIT_MAX ? BME_688_GAS_WAIT_MAX : high * 2;
+    }
+    while (high && high - low > 1)
+    {
+        uint16_t mid = low + (high - low) / 2;
+        if (decodeGasWait(encodeGasWait(mid)) >= high)
+            break;
+        if (runHeaterTrial(profile, mid))
+            high = mid;
+        else
+            low = mid;
+    }
+
+    if (!high)
+    {
+        uint16_t duration = tunedDuration(profile);
+        if (duration)
+            i2c_execute(BME_688_GAS_WAIT_PROFILE_REG + profile, encodeGasWait(duration));
+        else
+            setHeatProfiles();
+        BME688_LOG(BME_688_GAS_TUNE_FAILURE);
+        return false;
+    }
+    return setHeaterDuration(profile, high + (uint32_t)high * BME_688_GAS_TUNE_MARGIN / 100);
+}
+
+/**
+ * @brief Tune the heater duration of every profile
+ *
+ * @return true if all profiles were tuned
+ */
+bool BME688::tuneHeaterDurations()
+{
+    bool result = true;
+    for (uint8_t i = 0; i < BME_688_GAS_PROFILE_COUNT; i++)
+        result &= tuneHeaterDuration(i);
+    return result;
+}
+
+/**
+ * @brief Get the heater duration programmed for a profile
+ *
+ * @param profile Profile number (0-9)
+ * @return uint16_t Heater duration in ms, 0 if profile is out of range
+ */
+uint16_t BME688::getHeaterDuration(uint8_t profile)
+{
+    if (profile >= BME_688_GAS_PROFILE_COUNT)
+        return 0;
+    uint16_t duration = tunedDuration(profile);
+    if (duration)
+        return decodeGasWait(encodeGasWait(duration));
+    if (!ensureHeater())
+        return 0;
+    uint8_t code = 0;
+    i2c_readByte(BME_688_GAS_WAIT_PROFILE_REG + profile, &code, 1);
+    return decodeGasWait(code);
+}
+
+/**
+ * @brief Set the heater duration for a profile
+ *
+ * @param profile Profile number (0-9)
+ * @param duration Heater duration in ms, 0 to restore the default
+ * @return true if the duration was valid and applied
+ */
+bool BME688::setHeaterDuration(uint8_t profile, uint16_t duration)
+{
+    if (profile >= BME_688_GAS_PROFILE_COUNT || duration > BME_688_GAS_WAIT_MAX)
+    {
+        BME688_LOG(BME_688_VALUE_INVALID);
+        return false;
+    }
+    lock();
+    heatDuration[profile] = duration;
+    unlock();
+    if (duration)
+        i2c_execute(BME_688_GAS_WAIT_PROFILE_REG + profile, encodeGasWait(duration));
+    else
+        setHeatProfiles();
     return true;
 }
 
@@ -205,15 +654,125 @@ bool BME688::isConnected()
 bool BME688::setTemperatureOversampling(uint8_t oss)
 {
     if (oss <= BME_688_OSS_16)
+    {
+        lock();
         temp_oss = oss;
+        unlock();
+    }
     else
     {
-        printLog(BME_688_VALUE_INVALID);
+        BME688_LOG(BME_688_VALUE_INVALID);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Set pressure oversampling
+ *
+ * @param oss Oversampling setting (BME_688_OSS_0 to BME_688_OSS_16)
+ * @return true if setting was valid and applied
+ */
+bool BME688::setPressureOversampling(uint8_t oss)
+{
+    if (oss <= BME_688_OSS_16)
+    {
+        lock();
+        press_oss = oss;
+        unlock();
+    }
+    else
+    {
+        BME688_LOG(BME_688_VALUE_INVALID);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Set humidity oversampling
+ *
+ * @param oss Oversampling setting (BME_688_OSS_0 to BME_688_OSS_16)
+ * @return true if setting was valid and applied
+ */
+bool BME688::setHumidityOversampling(uint8_t oss)
+{
+    if (oss <= BME_688_OSS_16)
+    {
+        lock();
+        hum_oss = oss;
+        unlock();
+    }
+    else
+    {
+        BME688_LOG(BME_688_VALUE_INVALID);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Select the channels that are converted
+ *
+ * @param channels BME688_SAMPLE_* flags
+ * @return true if at least one channel is enabled
+ */
+bool BME688::setChannels(uint8_t channels)
+{
+    channels &= BME688_SAMPLE_ALL;
+    if (!channels)
+    {
+        BME688_LOG(BME_688_VALUE_INVALID);
         return false;
     }
+    if (channels & (BME688_SAMPLE_PRESSURE | BME688_SAMPLE_HUMIDITY))
+        channels |= BME688_SAMPLE_TEMPERATURE;
+    lock();
+    enabledChannels = channels;
+    bool ready = heaterReady;
+    unlock();
+
+    // Without gas, keep the heater off
+    if (!(channels & BME688_SAMPLE_GAS) && ready)
+        i2c_execute(BME_688_CTRL_GAS_REG, 0x00);
     return true;
 }
 
+/**
+ * @brief Get the enabled channels
+ *
+ * @return uint8_t BME688_SAMPLE_* flags
+ */
+uint8_t BME688::getChannels()
+{
+    lock();
+    uint8_t channels = enabledChannels;
+    unlock();
+    return channels;
+}
+
+/**
+ * @brief Check whether the gas channel is enabled
+ *
+ * @return true if gas readings are enabled
+ */
+bool BME688::gasEnabled()
+{
+    return getChannels() & BME688_SAMPLE_GAS;
+}
+
+/**
+ * @brief Get the conversion time of the enabled channels
+ *
+ * @return uint32_t Conversion time in µs, without the heater phase
+ */
+uint32_t BME688::getConversionTime()
+{
+    uint8_t ctrl_hum, ctrl_meas;
+    readConfig(&ctrl_hum, &ctrl_meas);
+    return conversionTime(ctrl_hum, ctrl_meas & ~BME_688_MODE_MASK);
+}
+
 /**
  * @brief Read raw temperature value from sensor
  *
@@ -223,7 +782,7 @@ int32_t BME688::readRawTemp()
 {
     int32_t raw = 0;
     if (!i2c_read_Xbit(BME_688_TEMP_RAW_REG, &raw, 20))
-        printLog(BME_688_READ_FAILURE);
+        BME688_LOG(BME_688_READ_FAILURE);
     return raw;
 }
 
@@ -236,7 +795,7 @@ int32_t BME688::readRawPres()
 {
     int32_t raw = 0;
     if (!i2c_read_Xbit(BME_688_PRES_RAW_REG, &raw, 20))
-        printLog(BME_688_READ_FAILURE);
+        BME688_LOG(BME_688_READ_FAILURE);
     return raw;
 }
 
@@ -249,7 +808,7 @@ int16_t BME688::readRawHum()
 {
     int16_t raw = 0;
     if (!i2c_read_Xbit(BME_688_HUM_RAW_REG, &raw, 16))
-        printLog(BME_688_READ_FAILURE);
+        BME688_LOG(BME_688_READ_FAILURE);
     return raw;
 }
 
@@ -262,93 +821,145 @@ int16_t BME688::readRawGas()
 {
     int16_t raw = 0;
     if (!i2c_read_Xbit(BME_688_HUM_RAW_REG, &raw, 16))
-        printLog(BME_688_READ_FAILURE);
+        BME688_LOG(BME_688_READ_FAILURE);
     return raw;
 }
 
 /**
- * @brief Convert raw temperature ADC value to degrees Celsius
+ * @brief Convert raw temperature ADC value to fine temperature
  *
+ * @param k Compensation coefficients from loadCoefficients()
  * @param adc_T Raw temperature value
- * @return double Temperature in °C
+ * @return float Fine temperature (°C x 5120)
  */
-double BME688::readUCTemp(int32_t adc_T)
+float BME688::readUCTemp(const Coefficients &k, int32_t adc_T)
 {
-    double var1 = (((double)adc_T / 16384.0) - ((double)par_t16[0] / 1024.0)) * (double)par_t16[1];
-    double var2 = ((((double)adc_T / 131072.0) - ((double)par_t16[0] / 8192.0)) *
-                   (((double)adc_T / 131072.0) - ((double)par_t16[0] / 8192.0))) *
-                  ((double)par_t3 * 16.0);
-
-    t_fine = var1 + var2;
-    return t_fine / 5120.0;
+    float u = (float)adc_T * (1.0f / 131072.0f) - k.t[0];
+    return u * (k.t[1] + k.t[2] * u);
 }
 
 /**
  * @brief Convert raw pressure ADC value to Pascals
  *
+ * @param k Compensation coefficients from loadCoefficients()
  * @param adc_P Raw pressure value
- * @return double Pressure in Pa
+ * @param t_fine Fine temperature from the same conversion
+ * @return float Pressure in Pa
  */
-double BME688::readUCPres(int32_t adc_P)
+float BME688::readUCPres(const Coefficients &k, int32_t adc_P, float t_fine)
 {
-    double var1 = 0.0, var2 = 0.0, var3 = 0.0;
-    double press_comp = 0.0;
-
-    var1 = ((double)t_fine / 2.0) - 64000.0;
-    var2 = var1 * var1 * ((double)par_p8[1] / 131072.0);
-    var2 = var2 + (var1 * (double)par_p16[3] * 2.0);
-    var2 = (var2 / 4.0) + ((double)par_p16[2] * 65536.0);
-    var1 = ((((double)par_p8[0] * var1 * var1) / 16384.0) + ((double)par_p16[1] * var1)) / 524288.0;
-    var1 = (1.0 + (var1 / 32768.0)) * (double)par_p1;
-    press_comp = 1048576.0 - (double)adc_P;
-    press_comp = ((press_comp - (var2 / 4096.0)) * 6250.0) / var1;
-    var1 = ((double)par_p16[5] * press_comp * press_comp) / 2147483648.0;
-    var2 = press_comp * ((double)par_p16[4] / 32768.0);
-    var3 = (press_comp / 256.0) * (press_comp / 256.0) * (press_comp / 256.0) * ((double)par_p10 / 131072.0);
-    p_fine = press_comp + (var1 + var2 + var3 + ((double)par_p8[2] * 128.0)) / 16.0;
-    return p_fine;
+    float v = t_fine * 0.5f - 64000.0f;
+    float var1 = k.p[0] + v * (k.p[1] + v * k.p[2]);
+    float var2 = k.p[3] + v * (k.p[4] + v * k.p[5]);
+    float x = ((1048576.0f - (float)adc_P) * 6250.0f - var2) / var1;
+    return x * (k.p[6] + x * (k.p[7] + x * k.p[8])) + k.p[9];
 }
 
 /**
  * @brief Convert raw humidity ADC value to percentage
  *
+ * @param k Compensation coefficients from loadCoefficients()
  * @param adc_H Raw humidity value
- * @return double Relative humidity in %
+ * @param t_fine Fine temperature from the same conversion
+ * @return float Relative humidity in %
  */
-double BME688::readUCHum(int16_t adc_H)
+float BME688::readUCHum(const Coefficients &k, int16_t adc_H, float t_fine)
 {
-    double t_fine = this->t_fine / 5120.0;
-    double var1 = 0, var2 = 0, var3 = 0, var4 = 0;
-
-    var1 = adc_H - (((double)par_h16[0] * 16.0) + (((double)par_h8[0] / 2.0) * t_fine));
-    var2 = var1 * (((double)par_h16[1] / 262144.0) * (1.0 + (((double)par_h8[1] / 16384.0) * t_fine) +
-                                                      (((double)par_h8[2] / 1048576.0) * t_fine * t_fine)));
-    var3 = (double)par_h6 / 16384.0;
-    var4 = (double)par_h8[4] / 2097152.0;
-    h_fine = var2 + ((var3 + (var4 * t_fine)) * var2 * var2);
-    return h_fine;
+    float var1 = (float)(uint16_t)adc_H - (k.h[0] + k.h[1] * t_fine);
+    float var2 = var1 * (k.h[2] + t_fine * (k.h[3] + t_fine * k.h[4]));
+    return var2 * (1.0f + var2 * (k.h[5] + k.h[6] * t_fine));
 }
 
 /**
  * @brief Calculate gas heater temperature for target temperature
  *
+ * @param k Compensation coefficients from loadCoefficients()
  * @param target_temp Target temperature in °C
  * @return uint8_t Calculated heater temperature
  */
-uint8_t BME688::readUCGas(uint16_t target_temp)
+uint8_t BME688::readUCGas(const Coefficients &k, uint16_t target_temp)
+{
+    lock();
+    float ambient = ambTemp;
+    unlock();
+    return (uint8_t)(k.g[0] + k.g[1] * (float)target_temp + k.g[2] * ambient);
+}
+
+/**
+ * @brief Copy the compensation coefficients
+ *
+ * Calibration may be (re)loaded by another task at any time, so every reading works on one
+ * copy taken under the lock instead of reading the shared set piecemeal.
+ *
+ * @param k Coefficients to fill in
+ */
+void BME688::loadCoefficients(Coefficients &k)
+{
+    lock();
+    k = coef;
+    unlock();
+}
+
+/**
+ * @brief Fold the calibration constants into the compensation coefficients
+ *
+ * Every calibration-only term of the Bosch floating point formulas is computed here once,
+ * so the per-sample compensation is a few multiply-adds (and one division for pressure).
+ *
+ * @param c Calibration constants read from the sensor
+ */
+void BME688::foldCalibration(const Calibration &c)
 {
-    double t_fine = this->t_fine / 5120.0;
-    double var1 = 0, var2 = 0, var3 = 0, var4 = 0, var5 = 0;
+    Coefficients k;
+
+    // t_fine = u * (t1 + t2 * u), with u = adc_T / 131072 - t0
+    k.t[0] = c.par_t1 / 8192.0f;
+    k.t[1] = c.par_t2 * 8.0f;
+    k.t[2] = c.par_t3 * 16.0f;
+
+    // With v = t_fine / 2 - 64000:
+    //   var1 = p0 + v * (p1 + v * p2)            (the divisor, already multiplied by par_p1)
+    //   var2 = p3 + v * (p4 + v * p5)            (already scaled by 6250 / 4096)
+    //   x = ((1048576 - adc_P) * 6250 - var2) / var1
+    //   pressure = x * (p6 + x * (p7 + x * p8)) + p9
+    const float scale = 6250.0f / 4096.0f;
+    k.p[0] = c.par_p1;
+    k.p[1] = c.par_p2 * (float)c.par_p1 / 17179869184.0f;      // 2^34
+    k.p[2] = c.par_p3 * (float)c.par_p1 / 281474976710656.0f; // 2^48
+    k.p[3] = c.par_p4 * 65536.0f * scale;
+    k.p[4] = c.par_p5 * 0.5f * scale;
+    k.p[5] = c.par_p6 / 524288.0f * scale;
+    k.p[6] = 1.0f + c.par_p8 / 524288.0f;                     // 2^19
+    k.p[7] = c.par_p9 / 34359738368.0f;                       // 2^35
+    k.p[8] = c.par_p10 / 35184372088832.0f;                   // 2^45
+    k.p[9] = c.par_p7 * 8.0f;
+
+    // With the temperature kept as t_fine (°C x 5120):
+    //   var1 = adc_H - (h0 + h1 * t_fine)
+    //   var2 = var1 * (h2 + t_fine * (h3 + t_fine * h4))
+    //   humidity = var2 * (1 + var2 * (h5 + h6 * t_fine))
+    float h2 = c.par_h2 / 262144.0f;
+    k.h[0] = c.par_h1 * 16.0f;
+    k.h[1] = c.par_h3 / 2.0f / 5120.0f;
+    k.h[2] = h2;
+    k.h[3] = h2 * c.par_h4 / 16384.0f / 5120.0f;
+    k.h[4] = h2 * c.par_h5 / 1048576.0f / (5120.0f * 5120.0f);
+    k.h[5] = c.par_h6 / 16384.0f;
+    k.h[6] = c.par_h7 / 2097152.0f / 5120.0f;
+
+    // res_heat = g0 + g1 * target + g2 * ambient
+    float gain = 3.4f * (4.0f / (4.0f + (float)((c.res_heat_range & BME_688_HEAT_RANGE_MASK) >> 4))) /
+                 (1.0f + c.res_heat_val * 0.002f);
+    float var1 = c.par_g1 / 16.0f + 49.0f;
+    float var2 = c.par_g2 / 32768.0f * 0.0005f + 0.00235f;
+    k.g[0] = gain * var1 - 3.4f * 25.0f;
+    k.g[1] = gain * var1 * var2;
+    k.g[2] = gain * c.par_g3 / 1024.0f;
 
-    var1 = ((double)par_g1 / 16.0) + 49.0;
-    var2 = (((double)par_g2 / 32768.0) * 0.0005) + 0.00235;
-    var3 = (double)par_g3 / 1024.0;
-    var4 = var1 * (1.0 + (var2 * (double)target_temp));
-    var5 = var4 + (var3 * (double)t_fine);
-    g_fine = (uint8_t)(3.4 * ((var5 * (4.0 / (4.0 + (double)((res_heat_range & BME_688_HEAT_RANGE_MASK) >> 4))) *
-                               (1.0 / (1.0 + ((double)res_heat_val * 0.002)))) -
-                              25));
-    return g_fine;
+    lock();
+    coef = k;
+    calibLoaded = true;
+    unlock();
 }
 
 /**
@@ -371,9 +982,24 @@ bool BME688::checkGasMeasurementCompletion()
  */
 double BME688::readTemperature()
 {
-    i2c_execute(BME_688_CTRL_MEAS_REG, temp_oss << 5 | press_oss << 2 | mode);
-    delay(10);
-    return readUCTemp(readRawTemp());
+    if (!ensureCalibration())
+        return NAN;
+    if (!(convert(BME688_SAMPLE_TEMPERATURE, 0) & BME688_SAMPLE_TEMPERATURE))
+        return NAN;
+    int32_t adc_T;
+    if (!i2c_read_Xbit(BME_688_TEMP_RAW_REG, &adc_T, 20))
+    {
+        BME688_LOG(BME_688_READ_FAILURE);
+        return NAN;
+    }
+    // Another task's conversion may have skipped temperature
+    if (adc_T == BME_688_TP_SKIPPED)
+        return NAN;
+    Coefficients k;
+    loadCoefficients(k);
+    float t_fine = readUCTemp(k, adc_T);
+    updateAmbient(t_fine);
+    return t_fine / 5120.0f;
 }
 
 /**
@@ -383,10 +1009,28 @@ double BME688::readTemperature()
  */
 double BME688::readPressure()
 {
-    i2c_execute(BME_688_CTRL_MEAS_REG, temp_oss << 5 | press_oss << 2 | mode);
-    delay(10);
-    float ps = readUCPres(readRawPres());
-    return ps;
+    uint8_t data[6];
+    if (!ensureCalibration())
+        return NAN;
+    if (!(convert(BME688_SAMPLE_PRESSURE, 0) & BME688_SAMPLE_PRESSURE))
+        return NAN;
+
+    // Pressure and temperature of the same conversion in one burst (0x1F - 0x24)
+    if (!i2c_readByte(BME_688_PRES_RAW_REG, data, sizeof(data)))
+    {
+        BME688_LOG(BME_688_READ_FAILURE);
+        return NAN;
+    }
+    int32_t adc_P = (uint32_t)data[0] << 12 | (uint32_t)data[1] << 4 | data[2] >> 4;
+    int32_t adc_T = (uint32_t)data[3] << 12 | (uint32_t)data[4] << 4 | data[5] >> 4;
+    // Another task's conversion may have skipped these channels
+    if (adc_P == BME_688_TP_SKIPPED || adc_T == BME_688_TP_SKIPPED)
+        return NAN;
+    Coefficients k;
+    loadCoefficients(k);
+    float t_fine = readUCTemp(k, adc_T);
+    updateAmbient(t_fine);
+    return readUCPres(k, adc_P, t_fine);
 }
 
 /**
@@ -396,10 +1040,28 @@ double BME688::readPressure()
  */
 double BME688::readHumidity()
 {
-    i2c_execute(BME_688_CTRL_MEAS_HUM_REG, hum_oss);
-    i2c_execute(BME_688_CTRL_MEAS_REG, temp_oss << 5 | press_oss << 2 | mode);
-    delay(10);
-    return readUCHum(readRawHum());
+    uint8_t data[5];
+    if (!ensureCalibration())
+        return NAN;
+    if (!(convert(BME688_SAMPLE_HUMIDITY, 0) & BME688_SAMPLE_HUMIDITY))
+        return NAN;
+
+    // Temperature and humidity of the same conversion in one burst (0x22 - 0x26)
+    if (!i2c_readByte(BME_688_TEMP_RAW_REG, data, sizeof(data)))
+    {
+        BME688_LOG(BME_688_READ_FAILURE);
+        return NAN;
+    }
+    int32_t adc_T = (uint32_t)data[0] << 12 | (uint32_t)data[1] << 4 | data[2] >> 4;
+    uint16_t adc_H = (uint16_t)data[3] << 8 | data[4];
+    // Another task's conversion may have skipped these channels
+    if (adc_T == BME_688_TP_SKIPPED || adc_H == BME_688_HUM_SKIPPED)
+        return NAN;
+    Coefficients k;
+    loadCoefficients(k);
+    float t_fine = readUCTemp(k, adc_T);
+    updateAmbient(t_fine);
+    return readUCHum(k, adc_H, t_fine);
 }
 
 /**
@@ -410,22 +1072,44 @@ double BME688::readHumidity()
  */
 double BME688::readGasForTemperature(uint16_t temperature)
 {
-    if (allowHighTemps || temperature <= BME_688_HEAT_PLATE_MAX_TEMP)
+    if (!gasEnabled())
+        return NAN;
+    if (!ensureHeater())
+        return -1.0;
+    lock();
+    bool allowHigh = allowHighTemps;
+    unlock();
+    if (allowHigh || temperature <= BME_688_HEAT_PLATE_MAX_TEMP)
     {
         if (temperature < BME_688_HEAT_PLATE_ULTRA_TEMP)
         {
-            uint8_t t_temp = readUCGas((uint16_t)temperature);
-            uint8_t t_wait = (uint8_t)(0.25 * t_temp - 17);
-            i2c_execute(BME_688_CTRL_GAS_REG, 0x20);
-            i2c_execute(BME_688_GAS_WAIT_PROFILE_REG, t_wait);
-            i2c_execute(BME_688_GAS_RES_HEAT_PROFILE_REG, t_temp);
-            return startGasMeasurement(BME_688_GAS_PROFILE_START, t_wait + 5);
+            // Heat for as long as the nearest profile at or above this temperature (tuned or default)
+            int16_t step = ((int16_t)temperature - BME_688_GAS_START_TEMP + 24) / 25;
+            uint16_t duration = getHeaterDuration(step < 0                            ? 0
+                                                  : step >= BME_688_GAS_PROFILE_COUNT ? BME_688_GAS_PROFILE_COUNT - 1
+                                                                                      : step);
+
+            // Profile 0 is borrowed for the measurement and restored afterwards
+            uint8_t wait, heat;
+            if (!duration || !i2c_readByte(BME_688_GAS_WAIT_PROFILE_REG, &wait, 1) ||
+                !i2c_readByte(BME_688_GAS_RES_HEAT_PROFILE_REG, &heat, 1))
+                return -1.0;
+            Coefficients k;
+            loadCoefficients(k);
+            uint8_t code = encodeGasWait(duration);
+            i2c_execute(BME_688_GAS_WAIT_PROFILE_REG, code);
+            i2c_execute(BME_688_GAS_RES_HEAT_PROFILE_REG, readUCGas(k, temperature));
+            double result =
+                startGasMeasurement(BME_688_GAS_PROFILE_START, decodeGasWait(code) + BME_688_GAS_READOUT_MARGIN);
+            i2c_execute(BME_688_GAS_WAIT_PROFILE_REG, wait);
+            i2c_execute(BME_688_GAS_RES_HEAT_PROFILE_REG, heat);
+            return result;
         }
         else
-            printLog(BME_688_TEMP_EXCEED_MAX_LIMIT);
+            BME688_LOG(BME_688_TEMP_EXCEED_MAX_LIMIT);
     }
     else
-        printLog(BME_688_TEMP_WARNING);
+        BME688_LOG(BME_688_TEMP_WARNING);
 
     return -1.0;
 }
@@ -438,10 +1122,17 @@ double BME688::readGasForTemperature(uint16_t temperature)
  */
 double BME688::readGas(uint8_t profile)
 {
-    if (profile >= 0 && profile < 10)
-        return startGasMeasurement(profile, (uint8_t)(0.25 * readUCGas(BME_688_GAS_START_TEMP * profile) - 17));
+    if (profile < BME_688_GAS_PROFILE_COUNT)
+    {
+        if (!gasEnabled())
+            return NAN;
+        if (!ensureHeater())
+            return -1.0;
+        // Wait for the duration programmed into the profile's gas_wait register (tuned or default)
+        return startGasMeasurement(profile, getHeaterDuration(profile) + BME_688_GAS_READOUT_MARGIN);
+    }
     else
-        printLog(BME_688_PROFILE_OUT_OF_RANGE);
+        BME688_LOG(BME_688_PROFILE_OUT_OF_RANGE);
     return -1.0;
 }
 
@@ -449,34 +1140,273 @@ double BME688::readGas(uint8_t profile)
  * @brief Start gas measurement and read results
  *
  * @param profile Profile number to use
- * @param waitTime Time to wait for measurement in ms
+ * @param waitTime Heater duration in ms
  * @return double Gas resistance in ohms or error code
  */
-double BME688::startGasMeasurement(uint8_t profile, uint8_t waitTime)
+double BME688::startGasMeasurement(uint8_t profile, uint16_t waitTime)
 {
-    i2c_execute(BME_688_CTRL_GAS_REG, BME_688_GAS_RUN | profile);
-    i2c_execute(BME_688_CTRL_MEAS_REG, mode);
-    delay(waitTime);
-    if (!checkGasMeasurementCompletion())
+    uint8_t data[2] = {0};
+
+    // Gas ADC, range and status bits in one burst (0x2C - 0x2D)
+    if (!runGasConversion(profile, waitTime) || !i2c_readByte(BME_688_GAS_ADC_REG, data, sizeof(data)) ||
+        (data[1] & (BME_688_GAS_HEAT_STAB_MASK | BME_688_GAS_VALID_REG_MASK)) != BME_688_GAS_MEAS_FINISH)
     {
-        printLog(BME_688_GAS_MEAS_FAILURE);
+        BME688_LOG(BME_688_GAS_MEAS_FAILURE);
         return -2.0;
     }
-    uint16_t gas_adc = 0;
-    uint8_t gas_range = 0;
-
-    i2c_read_Xbit(BME_688_GAS_ADC_REG, &gas_adc, 10);
-    i2c_readByte(BME_688_GAS_RANGE_REG, &gas_range, 1);
-
-    gas_range &= BME_688_GAS_RANGE_VAL_MASK;
+    return calcGasResistance((uint16_t)data[0] << 2 | data[1] >> 6, data[1] & BME_688_GAS_RANGE_VAL_MASK);
+}
 
+/**
+ * @brief Convert raw gas ADC value and range to resistance
+ *
+ * @param gas_adc Raw 10-bit gas ADC value
+ * @param gas_range Gas range (0-15)
+ * @return double Gas resistance in ohms
+ */
+double BME688::calcGasResistance(uint16_t gas_adc, uint8_t gas_range)
+{
     uint32_t var1 = int32_t(262144) >> gas_range;
     int32_t var2 = (int32_t)gas_adc - int32_t(512);
     var2 *= int32_t(3);
     var2 = int32_t(4096) + var2;
-    g_res = 1000000.0f * (float)var1 / (float)var2;
-    cf_p = BME_688_GAS_CORRECTION;
-    return g_res;
+    return 1000000.0f * (float)var1 / (float)var2;
+}
+
+/**
+ * @brief Read temperature, pressure and humidity from one conversion
+ *
+ * @param sample Sample to fill in
+ * @return true if new data was read
+ */
+bool BME688::readSample(BME688Sample &sample)
+{
+    if (!ensureCalibration())
+        return false;
+    return measureSample(sample, BME688_SAMPLE_TPH, 0);
+}
+
+/**
+ * @brief Read temperature, pressure, humidity and gas resistance from one conversion
+ *
+ * @param sample Sample to fill in
+ * @param profile Heater profile number (0-9)
+ * @return true if new data was read
+ */
+bool BME688::readSample(BME688Sample &sample, uint8_t profile)
+{
+    if (profile >= BME_688_GAS_PROFILE_COUNT)
+    {
+        BME688_LOG(BME_688_PROFILE_OUT_OF_RANGE);
+        return false;
+    }
+    if (!gasEnabled())
+        return readSample(sample);
+    if (!ensureHeater())
+        return false;
+    i2c_execute(BME_688_CTRL_GAS_REG, BME_688_GAS_RUN | profile);
+    return measureSample(sample, BME688_SAMPLE_ALL, getHeaterDuration(profile) + BME_688_GAS_READOUT_MARGIN);
+}
+
+/**
+ * @brief Trigger a conversion and read the whole field 0 in one burst
+ *
+ * @param sample Sample to fill in
+ * @param channels BME688_SAMPLE_* flags of the channels to convert
+ * @param heaterTime Heater duration in ms (0 without a gas reading)
+ * @return true if new data was read
+ */
+bool BME688::measureSample(BME688Sample &sample, uint8_t channels, uint16_t heaterTime)
+{
+    uint8_t field[BME_688_FIELD_LENGTH];
+
+    channels = convert(channels, heaterTime);
+    if (!channels)
+    {
+        BME688_LOG(BME_688_VALUE_INVALID);
+        return false;
+    }
+    if (!i2c_readByte(BME_688_FIELD0_REG, field, BME_688_FIELD_LENGTH) || !(field[0] & BME_688_GAS_NEW_DATA_MASK))
+    {
+        BME688_LOG(BME_688_READ_FAILURE);
+        return false;
+    }
+
+    parseField(field, sample, channels);
+    publish(sample);
+    return true;
+}
+
+/**
+ * @brief Compensate one raw field data block into a sample
+ *
+ * @param field Field data block (BME_688_FIELD_LENGTH bytes)
+ * @param sample Sample to fill in
+ * @param channels BME688_SAMPLE_* flags of the channels that were converted
+ */
+void BME688::parseField(const uint8_t *field, BME688Sample &sample, uint8_t channels)
+{
+    sample.timestamp = millis();
+    sample.temperature = 0;
+    sample.pressure = 0;
+    sample.humidity = 0;
+    sample.gasIndex = field[0] & BME_688_GAS_MEAS_INDEX_MASK;
+    sample.gasResistance = 0;
+    sample.status = 0;
+
+    // A channel reported as skipped was not measured, even if it was requested: another task
+    // may have started the conversion with a different channel set
+    int32_t adc_T = (uint32_t)field[5] << 12 | (uint32_t)field[6] << 4 | field[7] >> 4;
+    if ((channels & BME688_SAMPLE_TEMPERATURE) && adc_T != BME_688_TP_SKIPPED)
+    {
+        Coefficients k;
+        loadCoefficients(k);
+        float t_fine = readUCTemp(k, adc_T);
+        updateAmbient(t_fine);
+        float temperature = t_fine / 51.2f;
+        sample.temperature = (int16_t)(temperature + (temperature < 0 ? -0.5f : 0.5f));
+        sample.status |= BME688_SAMPLE_TEMPERATURE;
+
+        int32_t adc_P = (uint32_t)field[2] << 12 | (uint32_t)field[3] << 4 | field[4] >> 4;
+        if ((channels & BME688_SAMPLE_PRESSURE) && adc_P != BME_688_TP_SKIPPED)
+        {
+            float pressure = readUCPres(k, adc_P, t_fine);
+            sample.pressure = pressure > 0 ? (uint32_t)(pressure + 0.5f) : 0;
+            sample.status |= BME688_SAMPLE_PRESSURE;
+        }
+
+        uint16_t adc_H = (uint16_t)field[8] << 8 | field[9];
+        if ((channels & BME688_SAMPLE_HUMIDITY) && adc_H != BME_688_HUM_SKIPPED)
+        {
+            float humidity = readUCHum(k, adc_H, t_fine);
+            humidity = humidity < 0.0f ? 0.0f : (humidity > 100.0f ? 100.0f : humidity);
+            sample.humidity = (uint16_t)(humidity * 100.0f + 0.5f);
+            sample.status |= BME688_SAMPLE_HUMIDITY;
+        }
+    }
+
+    if ((channels & BME688_SAMPLE_GAS) &&
+        (field[16] & (BME_688_GAS_HEAT_STAB_MASK | BME_688_GAS_VALID_REG_MASK)) == BME_688_GAS_MEAS_FINISH)
+    {
+        uint16_t gas_adc = (uint16_t)field[15] << 2 | field[16] >> 6;
+        sample.gasResistance = (uint32_t)(calcGasResistance(gas_adc, field[16] & BME_688_GAS_RANGE_VAL_MASK) + 0.5);
+        sample.status |= BME688_SAMPLE_GAS;
+    }
+}
+
+/**
+ * @brief Pass a sample to the attached triggers and aggregator
+ *
+ * @param sample Sample to publish
+ */
+void BME688::publish(const BME688Sample &sample)
+{
+    lock();
+    BME688WindowStats *stats = statistics;
+    BME688Triggers *trig = triggers;
+    unlock();
+    if (trig)
+        trig->evaluate(sample);
+    if (stats)
+        stats->add(sample);
+}
+
+/**
+ * @brief Read all new samples buffered in the three result fields
+ *
+ * @param samples Array to fill in, oldest first
+ * @param maxSamples Size of the array
+ * @return uint8_t Number of new samples
+ */
+uint8_t BME688::readSamples(BME688Sample *samples, uint8_t maxSamples)
+{
+    uint8_t fields[BME_688_FIELD_COUNT][BME_688_FIELD_LENGTH], order[BME_688_FIELD_COUNT], count = 0;
+    uint8_t ctrl_hum, ctrl_meas, channels = readConfig(&ctrl_hum, &ctrl_meas);
+
+    if (!ensureCalibration())
+        return 0;
+
+    // Read all fields in one burst if the Wire buffer holds them, otherwise one burst per field
+    // so every field is still read from a single shadowed transaction
+    if (BME_688_FIELD_COUNT * BME_688_FIELD_LENGTH <= BME688_I2C_BURST)
+    {
+        if (!i2c_readByte(BME_688_FIELD0_REG, fields[0], BME_688_FIELD_COUNT * BME_688_FIELD_LENGTH))
+        {
+            BME688_LOG(BME_688_READ_FAILURE);
+            return 0;
+        }
+    }
+    else
+    {
+        for (uint8_t i = 0; i < BME_688_FIELD_COUNT; i++)
+        {
+            if (!i2c_readByte(BME_688_FIELD0_REG + i * BME_688_FIELD_LENGTH, fields[i], BME_688_FIELD_LENGTH))
+            {
+                BME688_LOG(BME_688_READ_FAILURE);
+                return 0;
+            }
+        }
+    }
+
+    // Sort the fields with new data by sub_meas_index (modulo 256)
+    for (uint8_t i = 0; i < BME_688_FIELD_COUNT; i++)
+    {
+        if (!(fields[i][0] & BME_688_GAS_NEW_DATA_MASK))
+            continue;
+        uint8_t j = count++;
+        while (j > 0 && (int8_t)(fields[i][1] - fields[order[j - 1]][1]) < 0)
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    // Skip fields that were returned by an earlier call
+    lock();
+    uint8_t first = 0;
+    if (subMeasValid)
+        while (first < count && (int8_t)(fields[order[first]][1] - lastSubMeas) <= 0)
+            first++;
+    if (count - first > maxSamples)
+        count = first + maxSamples;
+    if (first < count)
+    {
+        lastSubMeas = fields[order[count - 1]][1];
+        subMeasValid = true;
+    }
+    unlock();
+
+    for (uint8_t i = first; i < count; i++)
+    {
+        parseField(fields[order[i]], samples[i - first], channels);
+        publish(samples[i - first]);
+    }
+    return count - first;
+}
+
+/**
+ * @brief Attach a window aggregator to the sample output
+ *
+ * @param stats Aggregator to feed, NULL to detach
+ */
+void BME688::attachStatistics(BME688WindowStats *stats)
+{
+    lock();
+    statistics = stats;
+    unlock();
+}
+
+/**
+ * @brief Attach a trigger set to the sample output
+ *
+ * @param triggers Trigger set to evaluate, NULL to detach
+ */
+void BME688::attachTriggers(BME688Triggers *triggers)
+{
+    lock();
+    this->triggers = triggers;
+    unlock();
 }
 
 /**
@@ -486,8 +1416,154 @@ double BME688::startGasMeasurement(uint8_t profile, uint8_t waitTime)
  */
 void BME688::ignoreUnsafeTemperatureWarnings(bool ignore)
 {
+    lock();
     allowHighTemps = ignore;
-    printLog(BME_688_TEMP_UNSAFE_WARNING);
+    unlock();
+    BME688_LOG(BME_688_TEMP_UNSAFE_WARNING);
+}
+
+/**
+ * @brief Set the pins used to clock a stuck bus free
+ *
+ * @param sda SDA pin number
+ * @param scl SCL pin number
+ */
+void BME688::setBusPins(uint8_t sda, uint8_t scl)
+{
+    lock();
+    sdaPin = sda;
+    sclPin = scl;
+    unlock();
+}
+
+/**
+ * @brief Enable/disable automatic bus recovery on failed transactions
+ *
+ * @param enable true to call recover() when a transaction fails after all retries
+ */
+void BME688::setAutoRecovery(bool enable)
+{
+    lock();
+    autoRecovery = enable;
+    unlock();
+}
+
+/**
+ * @brief Recover from a wedged I2C bus without re-reading calibration
+ *
+ * @return true if the sensor responds after the reset
+ */
+bool BME688::recover()
+{
+    lock();
+    bool busy = recovering;
+    recovering = true;
+    if (!busy)
+    {
+#ifndef ARDUINO_ARCH_ESP8266
+        Wire.end();
+#endif
+        clearBus();
+        startBus();
+    }
+    unlock();
+    if (busy)
+        return false;
+
+    i2c_execute(BME_688_SOFT_RESET_REG, BME_688_SOFT_RESET_CMD);
+    delay(BME_688_RESET_DELAY);
+
+    // The reset restarts the sub-measurement counter
+    lock();
+    subMeasValid = false;
+    unlock();
+
+    bool connected = isConnected();
+    if (connected)
+    {
+        // Registers are back at their reset values, calibration in RAM is still valid
+        uint8_t ctrl_hum, ctrl_meas;
+        readConfig(&ctrl_hum, &ctrl_meas);
+        if ((ctrl_meas & BME_688_MODE_MASK) != BME_688_PARALLEL_MODE)
+            ctrl_meas &= ~BME_688_MODE_MASK;
+        i2c_execute(BME_688_CTRL_MEAS_HUM_REG, ctrl_hum);
+        i2c_execute(BME_688_CTRL_MEAS_REG, ctrl_meas);
+        i2c_execute(BME_688_IIR_FILTER_REG, BME_688_IIR_FILTER_C15);
+        lock();
+        bool ready = heaterReady;
+        unlock();
+        if (ready)
+            setHeatProfiles();
+    }
+    else
+        BME688_LOG(BME_688_BUS_RECOVERY_FAILURE);
+
+    lock();
+    recovering = false;
+    unlock();
+    return connected;
+}
+
+/**
+ * @brief Release a slave holding SDA low by clocking SCL, then issue a STOP
+ *
+ * @return true if SDA is released
+ */
+bool BME688::clearBus()
+{
+    if (sdaPin == BME688_NO_PIN || sclPin == BME688_NO_PIN)
+        return true;
+
+    pinMode(sdaPin, INPUT_PULLUP);
+    pinMode(sclPin, INPUT_PULLUP);
+    delayMicroseconds(BME688_BUS_CLEAR_DELAY);
+    if (digitalRead(sdaPin) == HIGH)
+        return true;
+
+    // Each pulse lets the slave shift out one more bit of the byte it is stuck in
+    for (uint8_t i = 0; i < BME688_BUS_CLEAR_PULSES && digitalRead(sdaPin) == LOW; i++)
+    {
+        digitalWrite(sclPin, LOW);
+        pinMode(sclPin, OUTPUT);
+        delayMicroseconds(BME688_BUS_CLEAR_DELAY);
+        pinMode(sclPin, INPUT_PULLUP);
+        delayMicroseconds(BME688_BUS_CLEAR_DELAY);
+    }
+
+    // STOP condition: SDA rises while SCL is high
+    digitalWrite(sdaPin, LOW);
+    pinMode(sdaPin, OUTPUT);
+    delayMicroseconds(BME688_BUS_CLEAR_DELAY);
+    pinMode(sdaPin, INPUT_PULLUP);
+    delayMicroseconds(BME688_BUS_CLEAR_DELAY);
+
+    return digitalRead(sdaPin) == HIGH;
+}
+
+/**
+ * @brief Start the I2C bus with a bounded transaction timeout where the core supports it
+ */
+void BME688::startBus()
+{
+    Wire.begin();
+#if defined(WIRE_HAS_TIMEOUT)
+    Wire.setWireTimeout(BME688_I2C_TIMEOUT, true);
+#elif defined(ARDUINO_ARCH_ESP32)
+    Wire.setTimeOut(BME688_I2C_TIMEOUT / 1000);
+#endif
+}
+
+/**
+ * @brief Run recover() after a failed transaction if auto recovery is enabled
+ *
+ * @return true if the bus was recovered and the transaction should be retried
+ */
+bool BME688::recoverBus()
+{
+    lock();
+    bool enabled = autoRecovery;
+    unlock();
+    return enabled && recover();
 }
 
 // I2C communication methods
@@ -497,13 +1573,27 @@ void BME688::ignoreUnsafeTemperatureWarnings(bool ignore)
  *
  * @param reg Register address
  * @param data Data to write
+ * @return true if the sensor acknowledged the write
  */
-void BME688::i2c_execute(uint8_t reg, uint8_t data)
+bool BME688::i2c_execute(uint8_t reg, uint8_t data)
 {
-    Wire.beginTransmission(_address);
-    Wire.write(reg);
-    Wire.write(data);
-    Wire.endTransmission(true);
+    // At most one recovery per transaction, so a sensor that keeps refusing it cannot loop forever
+    for (bool recovered = false;; recovered = true)
+    {
+        for (uint8_t attempt = 0; attempt < BME688_I2C_RETRIES; attempt++)
+        {
+            lock();
+            Wire.beginTransmission(_address);
+            Wire.write(reg);
+            Wire.write(data);
+            bool ok = Wire.endTransmission(true) == 0;
+            unlock();
+            if (ok)
+                return true;
+        }
+        if (recovered || !recoverBus())
+            return false;
+    }
 }
 
 /**
@@ -511,14 +1601,27 @@ void BME688::i2c_execute(uint8_t reg, uint8_t data)
  *
  * @param reg Register address
  * @param data 16-bit data to write
+ * @return true if the sensor acknowledged the write
  */
-void BME688::i2c_execute_16bit(uint8_t reg, uint16_t data)
+bool BME688::i2c_execute_16bit(uint8_t reg, uint16_t data)
 {
-    Wire.beginTransmission(_address);
-    Wire.write(reg);
-    Wire.write(data >> 8);
-    Wire.write(data & 0xFF);
-    Wire.endTransmission(true);
+    for (bool recovered = false;; recovered = true)
+    {
+        for (uint8_t attempt = 0; attempt < BME688_I2C_RETRIES; attempt++)
+        {
+            lock();
+            Wire.beginTransmission(_address);
+            Wire.write(reg);
+            Wire.write(data >> 8);
+            Wire.write(data & 0xFF);
+            bool ok = Wire.endTransmission(true) == 0;
+            unlock();
+            if (ok)
+                return true;
+        }
+        if (recovered || !recoverBus())
+            return false;
+    }
 }
 
 /**
@@ -531,13 +1634,26 @@ void BME688::i2c_execute_16bit(uint8_t reg, uint16_t data)
  */
 bool BME688::i2c_readByte(uint8_t reg, uint8_t *const data, uint8_t length)
 {
-    startTransmission(reg);
-    Wire.requestFrom(_address, length);
-    if (Wire.available() < length)
-        return false;
-    for (uint8_t i = 0; i < length; i++)
-        data[i] = Wire.read();
-    return true;
+    for (bool recovered = false;; recovered = true)
+    {
+        for (uint8_t attempt = 0; attempt < BME688_I2C_RETRIES; attempt++)
+        {
+            lock();
+            bool ok = startTransmission(reg);
+            if (ok)
+            {
+                Wire.requestFrom(_address, length);
+                ok = Wire.available() >= length;
+                for (uint8_t i = 0; ok && i < length; i++)
+                    data[i] = Wire.read();
+            }
+            unlock();
+            if (ok)
+                return true;
+        }
+        if (recovered || !recoverBus())
+            return false;
+    }
 }
 
 /**
@@ -550,25 +1666,20 @@ bool BME688::i2c_readByte(uint8_t reg, uint8_t *const data, uint8_t length)
  */
 bool BME688::i2c_readByte(uint8_t reg, int8_t *const data, uint8_t length)
 {
-    startTransmission(reg);
-    Wire.requestFrom(_address, length);
-    if (Wire.available() < length)
-        return false;
-    for (uint8_t i = 0; i < length; i++)
-        data[i] = Wire.read();
-    return true;
+    return i2c_readByte(reg, (uint8_t *)data, length);
 }
 
 /**
  * @brief Start I2C transmission for reading
  *
  * @param reg Register address to read from
+ * @return true if the sensor acknowledged the register address
  */
-void BME688::startTransmission(uint8_t reg)
+bool BME688::startTransmission(uint8_t reg)
 {
     Wire.beginTransmission(_address);
     Wire.write(reg);
-    Wire.endTransmission(false);
+    return Wire.endTransmission(false) == 0;
 }
 
 /**
@@ -578,10 +1689,11 @@ void BME688::startTransmission(uint8_t reg)
  */
 bool BME688::is_sensor_connected()
 {
+    lock();
     Wire.beginTransmission(_address);
     bool result = Wire.endTransmission() == 0;
-    Serial.println(result);
-    return true;
+    unlock();
+    return result;
 }
 
 /**
@@ -596,21 +1708,18 @@ bool BME688::is_sensor_connected()
 template <typename T> bool BME688::i2c_read_Xbit_LE(uint8_t reg, T *const data, uint8_t length)
 {
     uint8_t l = length % 8 ? (length + (8 - length % 8)) / 8 : length / 8;
-    startTransmission(reg);
-    Wire.requestFrom(_address, l);
-    if (Wire.available() == l)
-    {
-        T tempData = 0;
-        for (int i = 0; i < l; i++)
-            tempData |= (T)Wire.read() << 8 * i;
+    uint8_t buffer[sizeof(T)];
+    if (l > sizeof(T) || !i2c_readByte(reg, buffer, l))
+        return false;
 
-        if (length % 8)
-            tempData >>= (8 - length % 8);
+    T tempData = 0;
+    for (int i = 0; i < l; i++)
+        tempData |= (T)buffer[i] << 8 * i;
 
-        *data = (T)tempData;
-    }
-    else
-        return false;
+    if (length % 8)
+        tempData >>= (8 - length % 8);
+
+    *data = (T)tempData;
     return true;
 }
 
@@ -626,20 +1735,17 @@ template <typename T> bool BME688::i2c_read_Xbit_LE(uint8_t reg, T *const data,
 template <typename T> bool BME688::i2c_read_Xbit(uint8_t reg, T *const data, uint8_t length)
 {
     uint8_t l = length % 8 ? (length + (8 - length % 8)) / 8 : length / 8;
-    startTransmission(reg);
-    Wire.requestFrom(_address, l);
-    if (Wire.available() == l)
-    {
-        T tempData = 0;
-        for (int i = 0; i < l; i++)
-            tempData |= (T)Wire.read() << 8 * (l - 1 - i);
+    uint8_t buffer[sizeof(T)];
+    if (l > sizeof(T) || !i2c_readByte(reg, buffer, l))
+        return false;
 
-        if (length % 8)
-            tempData >>= (8 - length % 8);
+    T tempData = 0;
+    for (int i = 0; i < l; i++)
+        tempData |= (T)buffer[i] << 8 * (l - 1 - i);
 
-        *data = (T)tempData;
-    }
-    else
-        return false;
+    if (length % 8)
+        tempData >>= (8 - length % 8);
+
+    *data = (T)tempData;
     return true;
-}
\ No newline at end of file
+}
@@ -14,6 +14,7 @@
 #define BME688_SOLDERED_H
 
 #include "Arduino.h"
+#include <Wire.h>
 
 #ifdef __cplusplus
 
@@ -36,10 +37,40 @@
 #define BME688_E_SENSOR_NOT_ENABLED   -11 ///< Sensor not enabled
 #define BME688_E_SENSOR_NOT_POWERED   -12 ///< Sensor not powered
 
+// I2C Bus Handling
+#define BME688_I2C_RETRIES      3     ///< Attempts per I2C transaction before it is reported as failed
+#define BME688_I2C_TIMEOUT      25000 ///< I2C transaction timeout in microseconds (where the core supports it)
+#define BME688_BUS_CLEAR_PULSES 9     ///< SCL pulses used to release a stuck SDA line
+#define BME688_BUS_CLEAR_DELAY  5     ///< Half period of the bus clear clock in microseconds
+#define BME688_NO_PIN           0xFF  ///< Bus pin not configured
+
+#if defined(PIN_WIRE_SDA) && defined(PIN_WIRE_SCL)
+#define BME688_DEFAULT_SDA PIN_WIRE_SDA ///< Default SDA pin for bus recovery
+#define BME688_DEFAULT_SCL PIN_WIRE_SCL ///< Default SCL pin for bus recovery
+#elif (defined(SDA) && defined(SCL)) || defined(ARDUINO_ARCH_ESP32)
+// ESP32 cores declare SDA and SCL as constants rather than macros
+#define BME688_DEFAULT_SDA SDA ///< Default SDA pin for bus recovery
+#define BME688_DEFAULT_SCL SCL ///< Default SCL pin for bus recovery
+#else
+#define BME688_DEFAULT_SDA BME688_NO_PIN ///< Default SDA pin for bus recovery
+#define BME688_DEFAULT_SCL BME688_NO_PIN ///< Default SCL pin for bus recovery
+#endif
+
+// Soft Reset
+#define BME_688_SOFT_RESET_REG 0xE0 ///< Soft reset register
+#define BME_688_SOFT_RESET_CMD 0xB6 ///< Soft reset command
+#define BME_688_RESET_DELAY    10   ///< Start-up time after a soft reset (ms)
+
 // Control Registers
 #define BME_688_CTRL_MEAS_REG     0x74 ///< Measurement control register
 #define BME_688_CTRL_MEAS_HUM_REG 0x72 ///< Humidity measurement control register
 
+// Conversion Timing (Bosch BME68x measurement duration formula, in µs)
+#define BME_688_MEAS_CYCLE_TIME 1963      ///< Duration of one oversampling cycle
+#define BME_688_TPH_SWITCH_TIME (477 * 4) ///< Switching between temperature, pressure and humidity
+#define BME_688_GAS_MEAS_TIME   (477 * 5) ///< Gas measurement
+#define BME_688_WAKE_UP_TIME    1000      ///< Wake-up from sleep in forced mode
+
 // Oversampling Settings
 #define BME_688_OSS_NONE 0x00 ///< No oversampling
 #define BME_688_OSS_1    0x01 ///< 1x oversampling
@@ -52,6 +83,7 @@
 #define BME_688_SLEEP_MODE    0x00 ///< Sleep mode (low power)
 #define BME_688_FORCED_MODE   0x01 ///< Forced mode (single measurement)
 #define BME_688_PARALLEL_MODE 0x02 ///< Parallel mode (continuous measurement)
+#define BME_688_MODE_MASK     0x03 ///< Operation mode bits of the measurement control register
 
 // Data Registers
 #define BME_688_TEMP_RAW_REG  0x22 ///< Raw temperature data register
@@ -62,6 +94,18 @@
 #define BME_688_GAS_RANGE_REG 0x2C ///< Gas range register
 #define BME_688_GAS_ADC_REG   0x2C ///< Gas ADC data register
 
+// Raw values a conversion reports for the channels it skipped
+#define BME_688_TP_SKIPPED  0x80000 ///< Raw temperature or pressure of a skipped channel
+#define BME_688_HUM_SKIPPED 0x8000  ///< Raw humidity of a skipped channel
+
+// Calibration Data Blocks
+#define BME_688_CALIB1_REG    0x8A ///< Start of temperature and pressure calibration block
+#define BME_688_CALIB1_LENGTH 23   ///< Length of calibration block 1 (0x8A - 0xA0)
+#define BME_688_CALIB2_REG    0xE1 ///< Start of humidity, temperature and gas calibration block
+#define BME_688_CALIB2_LENGTH 14   ///< Length of calibration block 2 (0xE1 - 0xEE)
+#define BME_688_CALIB3_REG    0x00 ///< Start of heater resistance calibration block
+#define BME_688_CALIB3_LENGTH 3    ///< Length of calibration block 3 (0x00 - 0x02)
+
 // Temperature Calibration Registers
 #define BME_688_TEMP_CALIB1_REG 0xE9 ///< Temperature calibration parameter 1
 #define BME_688_TEMP_CALIB2_REG 0x8A ///< Temperature calibration parameter 2
@@ -139,6 +183,20 @@
 #define BME_688_GAS_WAIT_MULFAC3 0x02 ///< Multiplication factor 3
 #define BME_688_GAS_WAIT_MULFAC4 0x03 ///< Multiplication factor 4
 
+// Gas Wait Time Encoding
+#define BME_688_GAS_WAIT_VAL_MASK 0x3F  ///< Gas wait value bits (duration = value x 4^mulfac)
+#define BME_688_GAS_WAIT_MAX      0xFC0 ///< Longest encodable gas wait time (63 x 64 = 4032ms)
+#define BME_688_GAS_PROFILE_COUNT 10    ///< Number of heater profile steps
+
+// Heater Duration Tuning
+#define BME_688_GAS_TUNE_START       0x08 ///< First gas wait time tried while tuning (8ms)
+#define BME_688_GAS_TUNE_CONFIRM     3    ///< Consecutive stable readings required to accept a wait time
+#define BME_688_GAS_TUNE_COOLDOWN    200  ///< Pause between tuning trials so the plate starts cold (ms)
+#define BME_688_GAS_TUNE_MARGIN      10   ///< Safety margin added to a tuned wait time (%)
+#define BME_688_GAS_READOUT_MARGIN   5    ///< Extra delay after the heater phase before reading results (ms)
+#define BME_688_POLL_RETRIES         20   ///< Status polls after the expected end of a gas conversion
+#define BME_688_POLL_INTERVAL        1    ///< Pause between status polls (ms)
+
 // Predefined Gas Wait Times (in ms)
 #define BME_688_GAS_WAIT_PROFILE1  0x3C ///< Profile 1 wait time (60ms)
 #define BME_688_GAS_WAIT_PROFILE2  0x50 ///< Profile 2 wait time (80ms)
@@ -163,6 +221,35 @@
 #define BME_688_GAS_HEAT_PROFILE9  360 ///< Profile 9 target temperature
 #define BME_688_GAS_HEAT_PROFILE10 380 ///< Profile 10 target temperature
 
+// Field Data Registers
+#define BME_688_FIELD0_REG   0x1D ///< Start of field 0 (status, pressure, temperature, humidity, gas)
+#define BME_688_FIELD_LENGTH 17   ///< Length of one field data block in bytes
+#define BME_688_FIELD_COUNT  3    ///< Number of result fields (0x1D, 0x2E, 0x3F), all used in parallel mode
+
+// Largest read the Wire buffer holds in one transaction (needs <Wire.h>, included above)
+#if defined(I2C_BUFFER_LENGTH)
+#define BME688_I2C_BURST I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH)
+#define BME688_I2C_BURST BUFFER_LENGTH
+#else
+#define BME688_I2C_BURST 32
+#endif
+
+// Sample Status Flags
+#define BME688_SAMPLE_TEMPERATURE 0x01 ///< Sample contains a temperature reading
+#define BME688_SAMPLE_PRESSURE    0x02 ///< Sample contains a pressure reading
+#define BME688_SAMPLE_HUMIDITY    0x04 ///< Sample contains a humidity reading
+#define BME688_SAMPLE_GAS         0x08 ///< Sample contains a valid gas resistance reading
+#define BME688_SAMPLE_TPH         0x07 ///< Temperature, pressure and humidity flags combined
+#define BME688_SAMPLE_ALL         0x0F ///< All channel flags combined
+
+// Channel Indices
+#define BME688_CHANNEL_TEMPERATURE 0 ///< Temperature channel (0.01 °C)
+#define BME688_CHANNEL_PRESSURE    1 ///< Pressure channel (Pa)
+#define BME688_CHANNEL_HUMIDITY    2 ///< Humidity channel (0.01 %)
+#define BME688_CHANNEL_GAS         3 ///< Gas resistance channel (Ω)
+#define BME688_CHANNEL_COUNT       4 ///< Number of channels
+
 // Chip Identification
 #define BME_688_CHIP_ID_REG 0xD0 ///< Chip ID register address
 #define BME_688_CHIP_ID     0x61 ///< Expected chip ID value
@@ -172,6 +259,7 @@
 #define BME_688_GAS_CORRECTION_NIL 1.0    ///< No correction factor
 
 // ------------ ERROR MESSAGES -----------------
+// Messages are stored in flash. Build with -DBME688_NO_LOGS to leave them out entirely.
 #define BME_688_CHECK_CONN_ERR  "BME688 is disconnected. Check connections or make sure it is working."
 #define BME_688_TEMP_CAL_EXCEPT "Exception: Failed to read temperature calibration parameters"
 #define BME_688_PRES_CAL_EXCEPT "Exception: Failed to read pressure calibration parameters"
@@ -188,11 +276,39 @@
     "will raise the limit to 600°C."
 #define BME_688_TEMP_EXCEED_MAX_LIMIT "Exception: Operation blocked. The temperature value exceeds maximum limit."
 #define BME_688_PROFILE_OUT_OF_RANGE  "Exception: Operation blocked. Profile value should be between 0 and 9."
+#define BME_688_BUS_RECOVERY_FAILURE  "Exception: I2C bus recovery failed. Sensor did not respond after reset."
+#define BME_688_GAS_TUNE_FAILURE                                                                                       \
+    "Exception: Heater tuning failed. Plate did not stabilise within the maximum wait time."
 #define BME_688_TEMP_UNSAFE_WARNING                                                                                    \
     "Warning: Higher temperatures will degrade the lifespan of the sensor. It is recommended to use a value under "    \
     "425°C"
 
 
+class BME688WindowStats;
+class BME688Triggers;
+
+/**
+ * @brief Bus lock hook, called with the context passed to BME688::setBusLock().
+ */
+typedef void (*BME688LockCallback)(void *context);
+
+/**
+ * @struct BME688Sample
+ * @brief One compensated measurement stored in scaled integer units.
+ *
+ * Only the channels flagged in status contain valid data.
+ */
+struct BME688Sample
+{
+    uint32_t timestamp;     ///< millis() when the sample was taken
+    uint32_t pressure;      ///< Pressure in Pascals (Pa)
+    uint32_t gasResistance; ///< Gas resistance in ohms (Ω)
+    int16_t temperature;    ///< Temperature in 0.01 °C
+    uint16_t humidity;      ///< Relative humidity in 0.01 %
+    uint8_t gasIndex;       ///< Heater profile used for the gas reading
+    uint8_t status;         ///< BME688_SAMPLE_* flags of the valid channels
+};
+
 /**
  * @class BME688
  * @brief A driver class for interfacing with the BME688 sensor.
@@ -232,38 +348,134 @@ class BME688
      */
     bool begin(uint8_t mode, uint8_t oss);
 
+    /**
+     * @brief Initializes the BME688 sensor with the shortest possible start-up.
+     *
+     * Probes the chip ID once, writes the measurement configuration and turns the gas
+     * conversion off, in case a warm restart left it running. Calibration data is read
+     * on the first measurement and heater profiles are programmed on the first gas
+     * request.
+     * @return True if the sensor responded, false otherwise.
+     */
+    bool beginFast();
+
     /**
      * @brief Reads the current temperature from the sensor.
-     * @return Temperature in degrees Celsius.
+     * @return Temperature in degrees Celsius, or NAN if the channel is disabled or the sensor could not be read.
      */
     double readTemperature();
 
     /**
      * @brief Reads the current atmospheric pressure.
-     * @return Pressure in Pascals (Pa).
+     * @return Pressure in Pascals (Pa), or NAN if the channel is disabled or the sensor could not be read.
      */
     double readPressure();
 
     /**
      * @brief Reads the relative humidity from the sensor.
-     * @return Humidity as a percentage (%).
+     * @return Humidity as a percentage (%), or NAN if the channel is disabled or the sensor could not be read.
      */
     double readHumidity();
 
     /**
      * @brief Reads gas resistance for a given target temperature.
+     *
+     * Heater profile 0 is used for the measurement and restored afterwards. The plate is heated
+     * for the duration of the nearest profile at or above the temperature, tuned or default.
      * @param temperature The target temperature in degrees Celsius.
-     * @return Gas resistance in ohms (Ω).
+     * @return Gas resistance in ohms (Ω), or NAN if the channel is disabled.
      */
     double readGasForTemperature(uint16_t temperature);
 
     /**
      * @brief Reads gas resistance for a specific gas profile.
      * @param profile The gas measurement profile index.
-     * @return Gas resistance in ohms (Ω).
+     * @return Gas resistance in ohms (Ω), or NAN if the channel is disabled.
      */
     double readGas(uint8_t profile);
 
+    /**
+     * @brief Reads temperature, pressure and humidity from a single conversion.
+     *
+     * Only the enabled channels are converted and flagged in the sample status.
+     * @param sample Sample to fill in.
+     * @return True if new data was read, false otherwise (also when only gas is enabled).
+     */
+    bool readSample(BME688Sample &sample);
+
+    /**
+     * @brief Reads temperature, pressure, humidity and gas resistance from a single conversion.
+     * @param sample Sample to fill in.
+     * @param profile The heater profile index (0-9) used for the gas reading.
+     * @return True if new data was read, false otherwise. A gas reading that did not
+     *         stabilise, or a disabled gas channel, leaves BME688_SAMPLE_GAS cleared.
+     */
+    bool readSample(BME688Sample &sample, uint8_t profile);
+
+    /**
+     * @brief Reads every new sample buffered in the three result fields without starting a conversion.
+     *
+     * In parallel mode the sensor keeps measuring and fills up to three fields. They are read
+     * in one burst where the Wire buffer allows it, ordered by sub-measurement index, and fields
+     * already returned by an earlier call are skipped, so polling every few conversions loses
+     * no samples. Each sample carries the heater profile of its gas reading in gasIndex.
+     * @param samples Array to fill in, oldest sample first.
+     * @param maxSamples Size of the array (BME_688_FIELD_COUNT is enough).
+     * @return Number of new samples, 0 if none or on a read failure.
+     */
+    uint8_t readSamples(BME688Sample *samples, uint8_t maxSamples);
+
+    /**
+     * @brief Feeds every sample returned by readSample() into a window aggregator.
+     *
+     * The aggregator runs on the task calling readSample(); when several tasks read samples,
+     * only one of them should feed a given aggregator.
+     * @param stats Aggregator to feed, or NULL to detach.
+     */
+    void attachStatistics(BME688WindowStats *stats);
+
+    /**
+     * @brief Evaluates every sample returned by readSample() against a trigger set.
+     *
+     * Triggers are evaluated before the sample reaches an attached aggregator, on the task
+     * calling readSample(). Check BME688Triggers::pending() or use its callback to report.
+     * @param triggers Trigger set to evaluate, or NULL to detach.
+     */
+    void attachTriggers(BME688Triggers *triggers);
+
+    /**
+     * @brief Finds the shortest heater duration that reliably stabilises a heater profile.
+     *
+     * Grows the gas wait time from BME_688_GAS_TUNE_START until the heater reports a stable,
+     * valid reading, then bisects down to the shortest duration that still passes
+     * BME_688_GAS_TUNE_CONFIRM consecutive measurements. The result (plus BME_688_GAS_TUNE_MARGIN)
+     * is stored and used by readGas() for that profile from then on.
+     * @param profile The heater profile index (0-9).
+     * @return True if a working duration was found, false otherwise.
+     */
+    bool tuneHeaterDuration(uint8_t profile);
+
+    /**
+     * @brief Runs tuneHeaterDuration() for every heater profile.
+     * @return True if all profiles were tuned successfully, false otherwise.
+     */
+    bool tuneHeaterDurations();
+
+    /**
+     * @brief Returns the heater duration currently used for a heater profile.
+     * @param profile The heater profile index (0-9).
+     * @return Heater duration in milliseconds, or 0 if the profile is out of range.
+     */
+    uint16_t getHeaterDuration(uint8_t profile);
+
+    /**
+     * @brief Sets the heater duration for a heater profile, e.g. to restore previously tuned values.
+     * @param profile The heater profile index (0-9).
+     * @param duration Heater duration in milliseconds (1 - 4032), or 0 to return to the default.
+     * @return True if the duration was applied, false otherwise.
+     */
+    bool setHeaterDuration(uint8_t profile, uint16_t duration);
+
     /**
      * @brief Enables or disables logging for debugging purposes.
      * @param show Set to true to enable logs, false to disable.
@@ -291,6 +503,31 @@ class BME688
      */
     bool setHumidityOversampling(uint8_t oss);
 
+    /**
+     * @brief Selects the channels that are measured.
+     *
+     * Skipped channels are set to BME_688_OSS_NONE, so conversions get shorter (skipping pressure
+     * alone saves about 2 ms per sample at 1x oversampling). Temperature is always measured when
+     * pressure or humidity is enabled, since their compensation depends on it. Without
+     * BME688_SAMPLE_GAS the heater stays off. Reads of disabled channels return NAN, and
+     * readSample() leaves their status flags cleared.
+     * @param channels BME688_SAMPLE_* flags, e.g. BME688_SAMPLE_TEMPERATURE | BME688_SAMPLE_HUMIDITY.
+     * @return True if the mask was applied, false if it selects no channel.
+     */
+    bool setChannels(uint8_t channels);
+
+    /**
+     * @brief Returns the enabled channels.
+     * @return BME688_SAMPLE_* flags, including temperature when it is forced on.
+     */
+    uint8_t getChannels();
+
+    /**
+     * @brief Returns the duration of a forced conversion of the enabled channels.
+     * @return Conversion time in microseconds, without the heater phase.
+     */
+    uint32_t getConversionTime();
+
     /**
      * @brief Allows ignoring unsafe temperature warnings.
      * @param ignore Set to true to ignore warnings, false to keep them.
@@ -303,55 +540,148 @@ class BME688
      */
     bool isConnected();
 
+    /**
+     * @brief Recovers from a wedged I2C bus.
+     *
+     * Clocks a stuck SDA line free, restarts the bus, issues a soft reset and re-applies
+     * the oversampling, filter and heater configuration. Calibration data is kept in RAM.
+     * @return True if the sensor responds after recovery, false otherwise.
+     */
+    bool recover();
+
+    /**
+     * @brief Sets the pins recover() uses to clock a stuck bus free.
+     *
+     * Defaults to the core's Wire pins where they are known. Pass BME688_NO_PIN to skip bus clearing.
+     * @param sda SDA pin number.
+     * @param scl SCL pin number.
+     */
+    void setBusPins(uint8_t sda, uint8_t scl);
+
+    /**
+     * @brief Enables or disables automatic recovery.
+     *
+     * When enabled, a transaction that fails BME688_I2C_RETRIES times calls recover() and gets
+     * BME688_I2C_RETRIES more attempts. It is reported as failed if those fail too, even if the
+     * bus itself was recovered (e.g. a sensor that is missing on a healthy bus).
+     * @param enable Set to true to enable automatic recovery.
+     */
+    void setAutoRecovery(bool enable);
+
+    /**
+     * @brief Sets hooks that make the object safe to share between tasks.
+     *
+     * The lock is held only around each I2C burst transaction and each access to shared
+     * configuration, never across conversion or heater waits, so other devices on the same
+     * bus are not blocked while the sensor is measuring. Use the same mutex for every driver
+     * on the bus. Concurrent reads may pick up each other's conversion; a channel that conversion
+     * skipped reads as NAN, or is left out of the sample status. Call before starting the tasks.
+     * @param lockBus Called to take the lock (e.g. xSemaphoreTake).
+     * @param unlockBus Called to release the lock (e.g. xSemaphoreGive).
+     * @param context Passed to both hooks.
+     */
+    void setBusLock(BME688LockCallback lockBus, BME688LockCallback unlockBus, void *context = NULL);
+
+  protected:
+    // Compensation, protected so the host benchmark in /extras can compare it with the Bosch formulas
+
+    // Calibration constants as read from the sensor, grouped by size so the struct has no padding
+    struct Calibration
+    {
+        uint16_t par_t1, par_p1, par_h1, par_h2;
+        int16_t par_t2, par_p2, par_p4, par_p5, par_p8, par_p9, par_g2;
+        int8_t par_t3, par_p3, par_p6, par_p7, par_h3, par_h4, par_h5, par_h7, par_g1, par_g3, res_heat_val;
+        uint8_t par_p10, par_h6, res_heat_range;
+    };
+
+    // Compensation coefficients folded from the calibration constants (see foldCalibration()).
+    // Footprint trade-off: these 23 floats take 92 bytes of RAM per object where the 36 raw
+    // calibration bytes they replace did not, 56 bytes more, in exchange for a per-sample
+    // compensation of a few multiply-adds in float instead of the Bosch double formulas.
+    struct Coefficients
+    {
+        float t[3], p[10], h[7], g[3];
+    } coef = {};
+
+    static float readUCTemp(const Coefficients &k, int32_t adc_T);
+    static float readUCPres(const Coefficients &k, int32_t adc_P, float t_fine);
+    static float readUCHum(const Coefficients &k, int16_t adc_H, float t_fine);
+    uint8_t readUCGas(const Coefficients &k, uint16_t adc_G);
+    void foldCalibration(const Calibration &c);
+
   private:
     uint8_t temp_oss = BME_688_OSS_1, press_oss = BME_688_OSS_1, hum_oss = BME_688_OSS_1, mode = BME_688_FORCED_MODE;
 
-    bool printLogs = false;
-
     uint8_t _address;
 
-    // CALIBRATION CONSTANTS
-    int16_t par_t16[2] = {0};
-    int8_t par_t3 = 0;
-    uint16_t par_p1 = 0;
-    int16_t par_p16[6] = {0};
-    int8_t par_p8[4] = {0};
-    uint16_t par_h16[2] = {0};
-    int8_t par_h8[5] = {0};
-    uint8_t par_h6 = 0;
-    uint8_t par_p10 = 0, res_heat_range = 0;
-    int8_t par_g1 = 0, par_g3 = 0, res_heat_val = 0;
-    int16_t par_g2 = 0;
-    bool allowHighTemps = false;
-
-    // CALIBRATED READINGS
-    double t_fine = 0, p_fine = 0, h_fine = 0, g_fine = 0, g_res = 0;
-
-    // Gas Sensor Profile data
-    uint8_t measProfile = 0, targetTemp = 0, targetWaitTime = 0;
-
-    // Pressure correction factor
-    float cf_p = BME_688_GAS_CORRECTION_NIL;
+    // Bus recovery
+    uint8_t sdaPin = BME688_DEFAULT_SDA, sclPin = BME688_DEFAULT_SCL;
+
+    // Flags, only accessed under the lock (initialized in the constructor)
+    bool printLogs : 1;
+    bool autoRecovery : 1, recovering : 1;
+    bool allowHighTemps : 1;
+    bool calibLoaded : 1, heaterReady : 1;
+    bool subMeasValid : 1;
+
+    // Channels enabled with setChannels()
+    uint8_t enabledChannels = BME688_SAMPLE_ALL;
+
+    // Sub-measurement index of the last field returned by readSamples()
+    uint8_t lastSubMeas = 0;
+
+    // Ambient temperature for heater resistance calculation (°C)
+    int8_t ambTemp = 25;
+
+    // Sample consumers
+    BME688WindowStats *statistics = NULL;
+    BME688Triggers *triggers = NULL;
+
+    // Bus lock hooks
+    BME688LockCallback lockCallback = NULL, unlockCallback = NULL;
+    void *lockContext = NULL;
+
+    // Tuned heater durations in ms (0 = not tuned)
+    uint16_t heatDuration[BME_688_GAS_PROFILE_COUNT] = {0};
 
     int32_t readRawTemp();
     int32_t readRawPres();
     int16_t readRawHum();
     int16_t readRawGas();
-    double readUCTemp(int32_t adc_T);
-    double readUCPres(int32_t adc_P);
-    double readUCHum(int16_t adc_H);
-    uint8_t readUCGas(uint16_t adc_G);
-    double startGasMeasurement(uint8_t profile, uint8_t waitTime);
+    void loadCoefficients(Coefficients &k);
+    double calcGasResistance(uint16_t gas_adc, uint8_t gas_range);
+    double startGasMeasurement(uint8_t profile, uint16_t waitTime);
+    bool measureSample(BME688Sample &sample, uint8_t channels, uint16_t heaterTime);
+    void parseField(const uint8_t *field, BME688Sample &sample, uint8_t channels);
+    void publish(const BME688Sample &sample);
     bool setHeatProfiles();
+    bool runHeaterTrial(uint8_t profile, uint16_t duration);
+    static uint8_t encodeGasWait(uint16_t duration);
+    static uint16_t decodeGasWait(uint8_t code);
     bool checkGasMeasurementCompletion();
-    void printLog(String log);
-    void readCalibParams();
+    bool runGasConversion(uint8_t profile, uint16_t heaterTime);
+    bool waitForData(uint32_t wait);
+    void printLog(const __FlashStringHelper *log);
+    bool readCalibParams();
+    void lock();
+    void unlock();
+    uint8_t readConfig(uint8_t *ctrl_hum, uint8_t *ctrl_meas, uint8_t channels = BME688_SAMPLE_ALL);
+    static uint32_t conversionTime(uint8_t ctrl_hum, uint8_t ctrl_meas);
+    uint8_t convert(uint8_t channels, uint16_t heaterTime);
+    bool gasEnabled();
+    void updateAmbient(float t_fine);
+    uint16_t tunedDuration(uint8_t profile);
+    bool ensureCalibration();
+    bool ensureHeater();
     // I2C communication methods
-    void i2c_execute(uint8_t reg, uint8_t data);
-    void i2c_execute_16bit(uint8_t reg, uint16_t data);
+    void startBus();
+    bool clearBus();
+    bool recoverBus();
+    bool i2c_execute(uint8_t reg, uint8_t data);
+    bool i2c_execute_16bit(uint8_t reg, uint16_t data);
     bool i2c_readByte(uint8_t reg, uint8_t *const data, uint8_t length = 1);
     bool i2c_readByte(uint8_t reg, int8_t *const data, uint8_t length = 1);
-    void startTransmission(uint8_t reg);
+    bool startTransmission(uint8_t reg);
     bool is_sensor_connected();
 
     // Template methods for reading various bit lengths
@@ -0,0 +1,152 @@
+/**
+ **************************************************
+ *
+ * @file        BME688-Statistics.cpp
+ * @brief       Fixed-memory windowed summary statistics for BME688 samples
+ *              (min, max, mean, variance and count per channel)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include <BME688-Statistics.h>
+
+/**
+ * @brief Constructor for the window aggregator
+ *
+ * @param windowTime Window length in ms (0 = no time bound)
+ * @param windowSamples Samples per window (0 = no count bound)
+ */
+BME688WindowStats::BME688WindowStats(uint32_t windowTime, uint16_t windowSamples)
+    : windowTime(windowTime), windowSamples(windowSamples)
+{
+    memset(&last, 0, sizeof(last));
+    reset();
+}
+
+/**
+ * @brief Set the summary callback
+ *
+ * @param callback Function to call, NULL to disable
+ * @param context Passed to the callback
+ */
+void BME688WindowStats::setCallback(BME688SummaryCallback callback, void *context)
+{
+    this->callback = callback;
+    callbackContext = context;
+}
+
+/**
+ * @brief Discard the current window
+ */
+void BME688WindowStats::reset()
+{
+    memset(acc, 0, sizeof(acc));
+    samples = 0;
+}
+
+/**
+ * @brief Add a sample to the current window
+ *
+ * @param sample Sample to add
+ * @return true if a window was completed
+ */
+bool BME688WindowStats::add(const BME688Sample &sample)
+{
+    bool completed = false;
+
+    // A time-bounded window is closed by the first sample that falls outside it
+    if (samples && windowTime && sample.timestamp - start >= windowTime)
+    {
+        emit();
+        completed = true;
+        start += (sample.timestamp - start) / windowTime * windowTime;
+    }
+    if (!samples && !completed)
+        start = sample.timestamp;
+
+    if (sample.status & BME688_SAMPLE_TEMPERATURE)
+        accumulate(BME688_CHANNEL_TEMPERATURE, sample.temperature);
+    if (sample.status & BME688_SAMPLE_PRESSURE)
+        accumulate(BME688_CHANNEL_PRESSURE, sample.pressure);
+    if (sample.status & BME688_SAMPLE_HUMIDITY)
+        accumulate(BME688_CHANNEL_HUMIDITY, sample.humidity);
+    if (sample.status & BME688_SAMPLE_GAS)
+        accumulate(BME688_CHANNEL_GAS, sample.gasResistance > 0x7FFFFFFF ? 0x7FFFFFFF : sample.gasResistance);
+    end = sample.timestamp;
+    samples++;
+
+    // A count-bounded window is closed by its last sample
+    if (windowSamples && samples >= windowSamples)
+    {
+        emit();
+        completed = true;
+    }
+    return completed;
+}
+
+/**
+ * @brief Close the current window early
+ *
+ * @return true if a summary was produced
+ */
+bool BME688WindowStats::flush()
+{
+    if (!samples)
+        return false;
+    emit();
+    return true;
+}
+
+/**
+ * @brief Get the most recently completed summary
+ *
+ * @return const BME688Summary& Summary record
+ */
+const BME688Summary &BME688WindowStats::summary() const
+{
+    return last;
+}
+
+/**
+ * @brief Add one value to a channel accumulator (Welford's update)
+ *
+ * @param channel Channel index
+ * @param value Value in sample units
+ */
+void BME688WindowStats::accumulate(uint8_t channel, int32_t value)
+{
+    Accumulator &a = acc[channel];
+    if (!a.count || value < a.min)
+        a.min = value;
+    if (!a.count || value > a.max)
+        a.max = value;
+    if (a.count < 0xFFFF)
+        a.count++;
+
+    float delta = (float)value - a.mean;
+    a.mean += delta / a.count;
+    a.m2 += delta * ((float)value - a.mean);
+}
+
+/**
+ * @brief Publish the current window and start an empty one
+ */
+void BME688WindowStats::emit()
+{
+    last.start = start;
+    last.end = end;
+    for (uint8_t i = 0; i < BME688_CHANNEL_COUNT; i++)
+    {
+        last.channel[i].min = acc[i].min;
+        last.channel[i].max = acc[i].max;
+        last.channel[i].mean = acc[i].mean;
+        last.channel[i].variance = acc[i].count > 1 ? acc[i].m2 / (acc[i].count - 1) : 0.0f;
+        last.channel[i].count = acc[i].count;
+    }
+    reset();
+    if (callback)
+        callback(last, callbackContext);
+}
@@ -0,0 +1,118 @@
+/**
+ **************************************************
+ * @file        BME688-Statistics.h
+ * @brief       Fixed-memory windowed summary statistics for BME688 samples
+ *              (min, max, mean, variance and count per channel)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_STATISTICS_H
+#define BME688_STATISTICS_H
+
+#include "BME688-Soldered.h"
+
+#ifdef __cplusplus
+
+/**
+ * @struct BME688ChannelSummary
+ * @brief Statistics of one channel over one window, in the units of BME688Sample.
+ */
+struct BME688ChannelSummary
+{
+    int32_t min;    ///< Smallest value
+    int32_t max;    ///< Largest value
+    float mean;     ///< Mean value
+    float variance; ///< Sample variance (0 for fewer than two values)
+    uint16_t count; ///< Number of values, 0 if the channel had no data
+};
+
+/**
+ * @struct BME688Summary
+ * @brief Summary record of one window.
+ */
+struct BME688Summary
+{
+    uint32_t start;                                      ///< Timestamp of the window start (ms)
+    uint32_t end;                                        ///< Timestamp of the last sample in the window (ms)
+    BME688ChannelSummary channel[BME688_CHANNEL_COUNT]; ///< Per channel statistics (BME688_CHANNEL_*)
+};
+
+/**
+ * @brief Called with every completed window summary.
+ */
+typedef void (*BME688SummaryCallback)(const BME688Summary &summary, void *context);
+
+/**
+ * @class BME688WindowStats
+ * @brief Tumbling window aggregator using Welford's online algorithm.
+ *
+ * Memory use is fixed and no heap is used. A window closes when a sample arrives at or after
+ * windowTime ms from the window start, or when it holds windowSamples samples, whichever
+ * comes first. Either bound can be disabled with 0.
+ */
+class BME688WindowStats
+{
+  public:
+    /**
+     * @brief Creates a window aggregator.
+     * @param windowTime Window length in milliseconds (0 = no time bound).
+     * @param windowSamples Samples per window (0 = no count bound).
+     */
+    BME688WindowStats(uint32_t windowTime, uint16_t windowSamples = 0);
+
+    /**
+     * @brief Sets a callback that receives each completed summary.
+     * @param callback Function to call, or NULL to disable.
+     * @param context Passed to the callback.
+     */
+    void setCallback(BME688SummaryCallback callback, void *context = NULL);
+
+    /**
+     * @brief Adds a sample to the current window.
+     * @param sample Sample to add. Only channels flagged in its status are used.
+     * @return True if a window was completed; it is then available from summary().
+     */
+    bool add(const BME688Sample &sample);
+
+    /**
+     * @brief Closes the current window early.
+     * @return True if the window held any samples and a summary was produced.
+     */
+    bool flush();
+
+    /**
+     * @brief Discards the current window.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the most recently completed summary.
+     * @return Summary record.
+     */
+    const BME688Summary &summary() const;
+
+  private:
+    struct Accumulator
+    {
+        int32_t min, max;
+        float mean, m2;
+        uint16_t count;
+    };
+
+    Accumulator acc[BME688_CHANNEL_COUNT];
+    BME688Summary last;
+    uint32_t windowTime, start = 0, end = 0;
+    uint16_t windowSamples, samples = 0;
+    BME688SummaryCallback callback = NULL;
+    void *callbackContext = NULL;
+
+    void accumulate(uint8_t channel, int32_t value);
+    void emit();
+};
+
+#endif // __cplusplus
+#endif // BME688_STATISTICS_H
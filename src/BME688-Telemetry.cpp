@@ -0,0 +1,459 @@
+/**
+ **************************************************
+ *
+ * @file        BME688-Telemetry.cpp
+ * @brief       Compact, allocation-free encoders for BME688 samples
+ *              (packed binary, CBOR and delta/varint stream)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include <BME688-Telemetry.h>
+
+/**
+ * @brief Write a little-endian value of the given byte width
+ *
+ * @param out Output pointer
+ * @param value Value to write
+ * @param bytes Number of bytes
+ * @return uint8_t* Pointer past the written bytes
+ */
+static uint8_t *writeLE(uint8_t *out, uint32_t value, uint8_t bytes)
+{
+    for (uint8_t i = 0; i < bytes; i++)
+        *out++ = (uint8_t)(value >> 8 * i);
+    return out;
+}
+
+/**
+ * @brief Read a little-endian value of the given byte width
+ *
+ * @param in Input pointer
+ * @param bytes Number of bytes
+ * @return uint32_t Value read
+ */
+static uint32_t readLE(const uint8_t *in, uint8_t bytes)
+{
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bytes; i++)
+        value |= (uint32_t)in[i] << 8 * i;
+    return value;
+}
+
+/**
+ * @brief Write an unsigned LEB128 varint
+ *
+ * @param out Output pointer
+ * @param end End of the output buffer
+ * @param value Value to write
+ * @return uint8_t* Pointer past the written bytes, NULL if the buffer is too small
+ */
+static uint8_t *writeVarint(uint8_t *out, const uint8_t *end, uint32_t value)
+{
+    do
+    {
+        if (out == end)
+            return NULL;
+        *out++ = (uint8_t)(value & 0x7F) | (value > 0x7F ? 0x80 : 0x00);
+        value >>= 7;
+    } while (value);
+    return out;
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint
+ *
+ * @param in Input pointer
+ * @param end End of the input buffer
+ * @param value Value read
+ * @return const uint8_t* Pointer past the consumed bytes, NULL if malformed
+ */
+static const uint8_t *readVarint(const uint8_t *in, const uint8_t *end, uint32_t *value)
+{
+    *value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        if (in == end)
+            return NULL;
+        uint8_t b = *in++;
+        *value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return in;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Zigzag-map a signed delta so small magnitudes give short varints
+ */
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/**
+ * @brief Reverse of zigzag()
+ */
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Packed binary layout
+
+/**
+ * @brief Encode a sample into the fixed packed layout
+ *
+ * Layout: timestamp(4) temperature(2) pressure(3) humidity(2) gas(4) gasIndex(1) status(1)
+ *
+ * @param sample Sample to encode
+ * @param buffer Output buffer
+ * @param size Size of the output buffer
+ * @return size_t Bytes written, 0 if the buffer is too small
+ */
+size_t BME688Telemetry::encodePacked(const BME688Sample &sample, uint8_t *buffer, size_t size)
+{
+    if (size < BME688_PACKED_SIZE)
+        return 0;
+    uint8_t *out = buffer;
+    out = writeLE(out, sample.timestamp, 4);
+    out = writeLE(out, (uint16_t)sample.temperature, 2);
+    out = writeLE(out, sample.pressure > 0xFFFFFF ? 0xFFFFFF : sample.pressure, 3);
+    out = writeLE(out, sample.humidity, 2);
+    out = writeLE(out, sample.gasResistance, 4);
+    *out++ = sample.gasIndex;
+    *out++ = sample.status;
+    return out - buffer;
+}
+
+/**
+ * @brief Decode a sample from the fixed packed layout
+ *
+ * @param buffer Input buffer
+ * @param size Number of bytes available
+ * @param sample Decoded sample
+ * @return size_t Bytes consumed, 0 if the buffer is too short
+ */
+size_t BME688Telemetry::decodePacked(const uint8_t *buffer, size_t size, BME688Sample &sample)
+{
+    if (size < BME688_PACKED_SIZE)
+        return 0;
+    sample.timestamp = readLE(buffer, 4);
+    sample.temperature = (int16_t)readLE(buffer + 4, 2);
+    sample.pressure = readLE(buffer + 6, 3);
+    sample.humidity = readLE(buffer + 9, 2);
+    sample.gasResistance = readLE(buffer + 11, 4);
+    sample.gasIndex = buffer[15];
+    sample.status = buffer[16];
+    return BME688_PACKED_SIZE;
+}
+
+// CBOR
+
+/**
+ * @brief Write a CBOR head (major type and argument)
+ *
+ * @param out Output pointer
+ * @param end End of the output buffer
+ * @param major CBOR major type (0-7)
+ * @param value Argument value
+ * @return uint8_t* Pointer past the written bytes, NULL if the buffer is too small
+ */
+uint8_t *BME688Telemetry::writeCBORUint(uint8_t *out, const uint8_t *end, uint8_t major, uint32_t value)
+{
+    uint8_t extra = value < 24 ? 0 : (value <= 0xFF ? 1 : (value <= 0xFFFF ? 2 : 4));
+    if (!out || end - out < 1 + extra)
+        return NULL;
+    major <<= 5;
+    if (!extra)
+    {
+        *out++ = major | (uint8_t)value;
+        return out;
+    }
+    *out++ = major | (extra == 1 ? 24 : (extra == 2 ? 25 : 26));
+    while (extra--)
+        *out++ = (uint8_t)(value >> 8 * extra);
+    return out;
+}
+
+/**
+ * @brief Write a signed integer as a CBOR unsigned (major 0) or negative (major 1) item
+ */
+uint8_t *BME688Telemetry::writeCBORInt(uint8_t *out, const uint8_t *end, int32_t value)
+{
+    if (value < 0)
+        return writeCBORUint(out, end, 1, (uint32_t)(-(value + 1)));
+    return writeCBORUint(out, end, 0, (uint32_t)value);
+}
+
+/**
+ * @brief Read a CBOR integer item (major type 0 or 1)
+ *
+ * @param in Input pointer
+ * @param end End of the input buffer
+ * @param value Value read
+ * @return const uint8_t* Pointer past the item, NULL if malformed or not an integer
+ */
+const uint8_t *BME688Telemetry::readCBORInt(const uint8_t *in, const uint8_t *end, int64_t *value)
+{
+    if (!in || in == end)
+        return NULL;
+    uint8_t major = *in >> 5, info = *in & 0x1F;
+    in++;
+    if (major > 1 || info > 26 || info == 27)
+        return NULL;
+
+    uint32_t arg = info;
+    if (info >= 24)
+    {
+        uint8_t extra = 1 << (info - 24);
+        if (end - in < extra)
+            return NULL;
+        arg = 0;
+        while (extra--)
+            arg = arg << 8 | *in++;
+    }
+    *value = major ? -1 - (int64_t)arg : (int64_t)arg;
+    return in;
+}
+
+/**
+ * @brief Encode a sample as a CBOR map
+ *
+ * @param sample Sample to encode
+ * @param buffer Output buffer
+ * @param size Size of the output buffer
+ * @return size_t Bytes written, 0 if the buffer is too small
+ */
+size_t BME688Telemetry::encodeCBOR(const BME688Sample &sample, uint8_t *buffer, size_t size)
+{
+    const uint8_t *end = buffer + size;
+    uint8_t pairs = 2;
+    pairs += (sample.status & BME688_SAMPLE_TEMPERATURE) ? 1 : 0;
+    pairs += (sample.status & BME688_SAMPLE_PRESSURE) ? 1 : 0;
+    pairs += (sample.status & BME688_SAMPLE_HUMIDITY) ? 1 : 0;
+    pairs += (sample.status & BME688_SAMPLE_GAS) ? 2 : 0;
+
+    uint8_t *out = writeCBORUint(buffer, end, 5, pairs);
+    out = writeCBORUint(out, end, 0, BME688_CBOR_KEY_TIMESTAMP);
+    out = writeCBORUint(out, end, 0, sample.timestamp);
+    out = writeCBORUint(out, end, 0, BME688_CBOR_KEY_STATUS);
+    out = writeCBORUint(out, end, 0, sample.status);
+    if (sample.status & BME688_SAMPLE_TEMPERATURE)
+    {
+        out = writeCBORUint(out, end, 0, BME688_CBOR_KEY_TEMPERATURE);
+        out = writeCBORInt(out, end, sample.temperature);
+    }
+    if (sample.status & BME688_SAMPLE_PRESSURE)
+    {
+        out = writeCBORUint(out, end, 0, BME688_CBOR_KEY_PRESSURE);
+        out = writeCBORUint(out, end, 0, sample.pressure);
+    }
+    if (sample.status & BME688_SAMPLE_HUMIDITY)
+    {
+        out = writeCBORUint(out, end, 0, BME688_CBOR_KEY_HUMIDITY);
+        out = writeCBORUint(out, end, 0, sample.humidity);
+    }
+    if (sample.status & BME688_SAMPLE_GAS)
+    {
+        out = writeCBORUint(out, end, 0, BME688_CBOR_KEY_GAS);
+        out = writeCBORUint(out, end, 0, sample.gasResistance);
+        out = writeCBORUint(out, end, 0, BME688_CBOR_KEY_GAS_INDEX);
+        out = writeCBORUint(out, end, 0, sample.gasIndex);
+    }
+    return out ? out - buffer : 0;
+}
+
+/**
+ * @brief Decode a sample from a CBOR map
+ *
+ * @param buffer Input buffer
+ * @param size Number of bytes available
+ * @param sample Decoded sample
+ * @return size_t Bytes consumed, 0 if the data is malformed
+ */
+size_t BME688Telemetry::decodeCBOR(const uint8_t *buffer, size_t size, BME688Sample &sample)
+{
+    const uint8_t *end = buffer + size;
+    if (!size || (buffer[0] & 0xE0) != 0xA0 || (buffer[0] & 0x1F) >= 24)
+        return 0;
+
+    uint8_t pairs = buffer[0] & 0x1F;
+    const uint8_t *in = buffer + 1;
+    memset(&sample, 0, sizeof(sample));
+    while (pairs--)
+    {
+        int64_t key = 0, value = 0;
+        in = readCBORInt(in, end, &key);
+        in = readCBORInt(in, end, &value);
+        if (!in)
+            return 0;
+
+        switch (key)
+        {
+        case BME688_CBOR_KEY_TIMESTAMP:
+            sample.timestamp = (uint32_t)value;
+            break;
+        case BME688_CBOR_KEY_STATUS:
+            sample.status = (uint8_t)value;
+            break;
+        case BME688_CBOR_KEY_TEMPERATURE:
+            sample.temperature = (int16_t)value;
+            break;
+        case BME688_CBOR_KEY_PRESSURE:
+            sample.pressure = (uint32_t)value;
+            break;
+        case BME688_CBOR_KEY_HUMIDITY:
+            sample.humidity = (uint16_t)value;
+            break;
+        case BME688_CBOR_KEY_GAS:
+            sample.gasResistance = (uint32_t)value;
+            break;
+        case BME688_CBOR_KEY_GAS_INDEX:
+            sample.gasIndex = (uint8_t)value;
+            break;
+        default:
+            break;
+        }
+    }
+    return in - buffer;
+}
+
+// Delta stream
+
+/**
+ * @brief Constructor for the delta stream encoder
+ *
+ * @param keyframeInterval Records between keyframes (0 = only the first)
+ */
+BME688DeltaEncoder::BME688DeltaEncoder(uint16_t keyframeInterval) : interval(keyframeInterval)
+{
+    reset();
+}
+
+/**
+ * @brief Force the next record to be a keyframe
+ */
+void BME688DeltaEncoder::reset()
+{
+    memset(&last, 0, sizeof(last));
+    count = 0;
+}
+
+/**
+ * @brief Encode a sample as a delta record
+ *
+ * @param sample Sample to encode
+ * @param buffer Output buffer
+ * @param size Size of the output buffer
+ * @return size_t Bytes written, 0 if the buffer is too small
+ */
+size_t BME688DeltaEncoder::encode(const BME688Sample &sample, uint8_t *buffer, size_t size)
+{
+    const uint8_t *end = buffer + size;
+    bool keyframe = count == 0;
+    BME688Sample base = last;
+    if (keyframe)
+        memset(&base, 0, sizeof(base));
+
+    if (!size)
+        return 0;
+    uint8_t status = sample.status & ~BME688_DELTA_KEYFRAME;
+    buffer[0] = status | (keyframe ? BME688_DELTA_KEYFRAME : 0);
+
+    uint8_t *out = writeVarint(buffer + 1, end, zigzag((int32_t)(sample.timestamp - base.timestamp)));
+    if (out && (status & BME688_SAMPLE_TEMPERATURE))
+        out = writeVarint(out, end, zigzag((int32_t)sample.temperature - base.temperature));
+    if (out && (status & BME688_SAMPLE_PRESSURE))
+        out = writeVarint(out, end, zigzag((int32_t)(sample.pressure - base.pressure)));
+    if (out && (status & BME688_SAMPLE_HUMIDITY))
+        out = writeVarint(out, end, zigzag((int32_t)sample.humidity - base.humidity));
+    if (out && (status & BME688_SAMPLE_GAS))
+        out = writeVarint(out, end, zigzag((int32_t)(sample.gasResistance - base.gasResistance)));
+    if (out && (status & BME688_SAMPLE_GAS))
+        out = writeVarint(out, end, sample.gasIndex);
+    if (!out)
+        return 0;
+
+    // Channels missing from this record keep their previous value on both ends
+    base.timestamp = sample.timestamp;
+    if (status & BME688_SAMPLE_TEMPERATURE)
+        base.temperature = sample.temperature;
+    if (status & BME688_SAMPLE_PRESSURE)
+        base.pressure = sample.pressure;
+    if (status & BME688_SAMPLE_HUMIDITY)
+        base.humidity = sample.humidity;
+    if (status & BME688_SAMPLE_GAS)
+        base.gasResistance = sample.gasResistance;
+    last = base;
+    if (interval && ++count >= interval)
+        count = 0;
+    else if (!interval)
+        count = 1;
+    return out - buffer;
+}
+
+/**
+ * @brief Constructor for the delta stream decoder
+ */
+BME688DeltaDecoder::BME688DeltaDecoder()
+{
+    reset();
+}
+
+/**
+ * @brief Discard the stream state
+ */
+void BME688DeltaDecoder::reset()
+{
+    memset(&last, 0, sizeof(last));
+    synced = false;
+}
+
+/**
+ * @brief Decode a delta record
+ *
+ * @param buffer Input buffer
+ * @param size Number of bytes available
+ * @param sample Decoded sample
+ * @return size_t Bytes consumed, 0 if malformed or not yet synced to a keyframe
+ */
+size_t BME688DeltaDecoder::decode(const uint8_t *buffer, size_t size, BME688Sample &sample)
+{
+    const uint8_t *end = buffer + size;
+    if (!size)
+        return 0;
+    uint8_t status = buffer[0] & ~BME688_DELTA_KEYFRAME;
+    bool keyframe = buffer[0] & BME688_DELTA_KEYFRAME;
+    if (!keyframe && !synced)
+        return 0;
+
+    BME688Sample base = last;
+    if (keyframe)
+        memset(&base, 0, sizeof(base));
+
+    uint32_t value = 0;
+    const uint8_t *in = readVarint(buffer + 1, end, &value);
+    base.timestamp += unzigzag(value);
+    if (in && (status & BME688_SAMPLE_TEMPERATURE) && (in = readVarint(in, end, &value)))
+        base.temperature += unzigzag(value);
+    if (in && (status & BME688_SAMPLE_PRESSURE) && (in = readVarint(in, end, &value)))
+        base.pressure += unzigzag(value);
+    if (in && (status & BME688_SAMPLE_HUMIDITY) && (in = readVarint(in, end, &value)))
+        base.humidity += unzigzag(value);
+    if (in && (status & BME688_SAMPLE_GAS) && (in = readVarint(in, end, &value)))
+        base.gasResistance += unzigzag(value);
+    if (in && (status & BME688_SAMPLE_GAS) && (in = readVarint(in, end, &value)))
+        base.gasIndex = (uint8_t)value;
+    if (!in)
+        return 0;
+
+    base.status = status;
+    last = base;
+    synced = true;
+    sample = base;
+    return in - buffer;
+}
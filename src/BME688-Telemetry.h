@@ -0,0 +1,155 @@
+/**
+ **************************************************
+ * @file        BME688-Telemetry.h
+ * @brief       Compact, allocation-free encoders for BME688 samples
+ *              (packed binary, CBOR and delta/varint stream)
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_TELEMETRY_H
+#define BME688_TELEMETRY_H
+
+#include "BME688-Soldered.h"
+
+#ifdef __cplusplus
+
+// Encoded Sizes (bytes)
+#define BME688_PACKED_SIZE    17 ///< Size of a packed binary sample
+#define BME688_CBOR_MAX_SIZE  33 ///< Largest CBOR encoded sample
+#define BME688_DELTA_MAX_SIZE 23 ///< Largest delta stream record
+
+// CBOR Map Keys
+#define BME688_CBOR_KEY_TIMESTAMP   0 ///< Sample timestamp (ms)
+#define BME688_CBOR_KEY_STATUS      1 ///< Sample status flags
+#define BME688_CBOR_KEY_TEMPERATURE 2 ///< Temperature (0.01 °C)
+#define BME688_CBOR_KEY_PRESSURE    3 ///< Pressure (Pa)
+#define BME688_CBOR_KEY_HUMIDITY    4 ///< Relative humidity (0.01 %)
+#define BME688_CBOR_KEY_GAS         5 ///< Gas resistance (Ω)
+#define BME688_CBOR_KEY_GAS_INDEX   6 ///< Heater profile of the gas reading
+
+// Delta Stream
+#define BME688_DELTA_KEYFRAME 0x80 ///< Record header flag: values are absolute, not deltas
+
+/**
+ * @class BME688Telemetry
+ * @brief Stateless encoders and decoders for single BME688 samples.
+ *
+ * All functions write into a caller-provided buffer and never allocate. They return the
+ * number of bytes written or consumed, or 0 if the buffer is too small or malformed.
+ */
+class BME688Telemetry
+{
+  public:
+    /**
+     * @brief Encodes a sample into a fixed BME688_PACKED_SIZE byte little-endian layout.
+     * @param sample Sample to encode.
+     * @param buffer Output buffer.
+     * @param size Size of the output buffer.
+     * @return Number of bytes written.
+     */
+    static size_t encodePacked(const BME688Sample &sample, uint8_t *buffer, size_t size);
+
+    /**
+     * @brief Decodes a sample written by encodePacked().
+     * @param buffer Input buffer.
+     * @param size Number of bytes available.
+     * @param sample Decoded sample.
+     * @return Number of bytes consumed.
+     */
+    static size_t decodePacked(const uint8_t *buffer, size_t size, BME688Sample &sample);
+
+    /**
+     * @brief Encodes a sample as a CBOR map with small integer keys (BME688_CBOR_KEY_*).
+     *
+     * Channels not flagged in the sample status are left out of the map.
+     * @param sample Sample to encode.
+     * @param buffer Output buffer.
+     * @param size Size of the output buffer.
+     * @return Number of bytes written.
+     */
+    static size_t encodeCBOR(const BME688Sample &sample, uint8_t *buffer, size_t size);
+
+    /**
+     * @brief Decodes a sample written by encodeCBOR().
+     * @param buffer Input buffer.
+     * @param size Number of bytes available.
+     * @param sample Decoded sample.
+     * @return Number of bytes consumed.
+     */
+    static size_t decodeCBOR(const uint8_t *buffer, size_t size, BME688Sample &sample);
+
+  private:
+    static uint8_t *writeCBORInt(uint8_t *out, const uint8_t *end, int32_t value);
+    static uint8_t *writeCBORUint(uint8_t *out, const uint8_t *end, uint8_t major, uint32_t value);
+    static const uint8_t *readCBORInt(const uint8_t *in, const uint8_t *end, int64_t *value);
+};
+
+/**
+ * @class BME688DeltaEncoder
+ * @brief Encodes consecutive samples as zigzag varint deltas from the previous sample.
+ *
+ * Each record starts with the sample status byte; BME688_DELTA_KEYFRAME marks a record
+ * holding absolute values. The first record after reset() is always a keyframe.
+ */
+class BME688DeltaEncoder
+{
+  public:
+    /**
+     * @brief Creates a delta encoder.
+     * @param keyframeInterval Emit a keyframe every this many records (0 = only the first).
+     */
+    BME688DeltaEncoder(uint16_t keyframeInterval = 0);
+
+    /**
+     * @brief Forces the next record to be a keyframe.
+     */
+    void reset();
+
+    /**
+     * @brief Encodes the next sample of the stream.
+     * @param sample Sample to encode.
+     * @param buffer Output buffer.
+     * @param size Size of the output buffer.
+     * @return Number of bytes written, 0 if the buffer was too small (stream state is unchanged).
+     */
+    size_t encode(const BME688Sample &sample, uint8_t *buffer, size_t size);
+
+  private:
+    BME688Sample last;
+    uint16_t interval, count = 0;
+};
+
+/**
+ * @class BME688DeltaDecoder
+ * @brief Decodes records produced by BME688DeltaEncoder.
+ */
+class BME688DeltaDecoder
+{
+  public:
+    BME688DeltaDecoder();
+
+    /**
+     * @brief Discards the stream state. The next record must be a keyframe.
+     */
+    void reset();
+
+    /**
+     * @brief Decodes the next record of the stream.
+     * @param buffer Input buffer.
+     * @param size Number of bytes available.
+     * @param sample Decoded sample.
+     * @return Number of bytes consumed, 0 if the record is malformed or no keyframe was seen yet.
+     */
+    size_t decode(const uint8_t *buffer, size_t size, BME688Sample &sample);
+
+  private:
+    BME688Sample last;
+    bool synced = false;
+};
+
+#endif // __cplusplus
+#endif // BME688_TELEMETRY_H
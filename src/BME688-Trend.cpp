@@ -0,0 +1,186 @@
+/**
+ **************************************************
+ *
+ * @file        BME688-Trend.cpp
+ * @brief       Fixed-size barometric trend tracker (pressure tendency and
+ *              least-squares slope) for the BME688
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include <BME688-Trend.h>
+
+/**
+ * @brief Constructor for the trend tracker
+ *
+ * @param interval Slot length in seconds
+ */
+BME688PressureTrend::BME688PressureTrend(uint32_t interval)
+{
+    memset(&s, 0, sizeof(s));
+    s.magic = BME688_TREND_MAGIC;
+    s.capacity = BME688_TREND_CAPACITY;
+    s.interval = interval ? interval : 1;
+}
+
+/**
+ * @brief Clear the history
+ */
+void BME688PressureTrend::reset()
+{
+    s.count = s.head = 0;
+    s.slotCount = 0;
+    s.slotMean = 0.0f;
+    s.sumY = 0;
+    s.sumXY = 0;
+}
+
+/**
+ * @brief Add a pressure sample
+ *
+ * @param time Sample time in seconds
+ * @param pressure Pressure in Pa
+ */
+void BME688PressureTrend::add(uint32_t time, float pressure)
+{
+    float value = pressure > 0.0f ? pressure * 10.0f : 0.0f;
+
+    if (!s.count && !s.slotCount)
+        s.slotStart = time;
+
+    // Time going backwards wraps to a huge gap and clears the history
+    uint32_t passed = (time - s.slotStart) / s.interval;
+    if (passed > BME688_TREND_CAPACITY)
+    {
+        reset();
+        s.slotStart = time;
+    }
+    else if (passed)
+    {
+        push((uint32_t)(s.slotMean + 0.5f));
+        for (uint32_t i = 1; i < passed; i++)
+            push(slot(0));
+        s.slotStart += passed * s.interval;
+        s.slotCount = 0;
+        s.slotMean = 0.0f;
+    }
+
+    if (s.slotCount < 0xFFFF)
+        s.slotCount++;
+    s.slotMean += (value - s.slotMean) / s.slotCount;
+}
+
+/**
+ * @brief Append a completed slot and update the least-squares sums
+ *
+ * @param value Slot mean in 0.1 Pa
+ */
+void BME688PressureTrend::push(uint32_t value)
+{
+    if (s.count < BME688_TREND_CAPACITY)
+    {
+        s.sumXY += (int64_t)s.count * value;
+        s.sumY += value;
+        s.count++;
+    }
+    else
+    {
+        // The oldest slot drops out and every other slot moves one index down
+        uint32_t oldest = s.slots[s.head];
+        s.sumXY += (int64_t)(BME688_TREND_CAPACITY - 1) * value - (int64_t)(s.sumY - oldest);
+        s.sumY += value - oldest;
+    }
+    s.slots[s.head] = value;
+    s.head = (s.head + 1) % BME688_TREND_CAPACITY;
+}
+
+/**
+ * @brief Get a completed slot by age
+ *
+ * @param age 0 for the newest slot
+ * @return uint32_t Slot mean in 0.1 Pa
+ */
+uint32_t BME688PressureTrend::slot(uint8_t age) const
+{
+    return s.slots[(s.head + BME688_TREND_CAPACITY - 1 - age) % BME688_TREND_CAPACITY];
+}
+
+/**
+ * @brief Get the number of completed slots
+ *
+ * @return uint8_t Slot count
+ */
+uint8_t BME688PressureTrend::size() const
+{
+    return s.count;
+}
+
+/**
+ * @brief Get the newest completed slot
+ *
+ * @return float Pressure in Pa, NAN if empty
+ */
+float BME688PressureTrend::latest() const
+{
+    return s.count ? slot(0) / 10.0f : NAN;
+}
+
+/**
+ * @brief Get the pressure change over a horizon
+ *
+ * @param horizon Horizon in seconds
+ * @return float Change in Pa, NAN if the history is too short
+ */
+float BME688PressureTrend::tendency(uint32_t horizon) const
+{
+    uint32_t slots = horizon / s.interval;
+    if (!s.count || slots >= s.count)
+        return NAN;
+    return ((int32_t)slot(0) - (int32_t)slot(slots)) / 10.0f;
+}
+
+/**
+ * @brief Get the least-squares slope of the history
+ *
+ * @return float Slope in Pa per hour, NAN with fewer than two slots
+ */
+float BME688PressureTrend::slope() const
+{
+    if (s.count < 2)
+        return NAN;
+
+    // x runs 0..n-1, so sum(x) and sum(x^2) have closed forms
+    int64_t n = s.count;
+    int64_t sumX = n * (n - 1) / 2;
+    int64_t num = n * s.sumXY - sumX * (int64_t)s.sumY;
+    int64_t den = n * n * (n * n - 1) / 12;
+    return (float)num / (float)den * (3600.0f / s.interval) / 10.0f;
+}
+
+/**
+ * @brief Get the state for saving
+ *
+ * @return const BME688TrendState& State record
+ */
+const BME688TrendState &BME688PressureTrend::state() const
+{
+    return s;
+}
+
+/**
+ * @brief Restore a saved state
+ *
+ * @param saved State from state()
+ * @return true if the state was valid
+ */
+bool BME688PressureTrend::restore(const BME688TrendState &saved)
+{
+    if (saved.magic != BME688_TREND_MAGIC || saved.capacity != BME688_TREND_CAPACITY ||
+        saved.count > BME688_TREND_CAPACITY || saved.head >= BME688_TREND_CAPACITY || !saved.interval)
+        return false;
+    s = saved;
+    return true;
+}
@@ -0,0 +1,125 @@
+/**
+ **************************************************
+ * @file        BME688-Trend.h
+ * @brief       Fixed-size barometric trend tracker (pressure tendency and
+ *              least-squares slope) for the BME688
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_TREND_H
+#define BME688_TREND_H
+
+#include "BME688-Soldered.h"
+
+#ifdef __cplusplus
+
+// Trend History
+#ifndef BME688_TREND_CAPACITY
+#define BME688_TREND_CAPACITY 37 ///< History slots (37 slots of 5 min span 3 hours), at most 255
+#endif
+#define BME688_TREND_INTERVAL 300    ///< Default slot length in seconds (5 min)
+#define BME688_TREND_MAGIC    0xB688 ///< Marks a valid saved state
+
+/**
+ * @struct BME688TrendState
+ * @brief Complete state of a BME688PressureTrend, safe to copy into RTC memory or EEPROM.
+ */
+struct BME688TrendState
+{
+    uint16_t magic;                        ///< BME688_TREND_MAGIC when valid
+    uint8_t capacity;                      ///< BME688_TREND_CAPACITY the state was built with
+    uint8_t count;                         ///< Number of completed slots
+    uint8_t head;                          ///< Slot written next
+    uint16_t slotCount;                    ///< Samples in the current slot
+    uint32_t interval;                     ///< Slot length in seconds
+    uint32_t slotStart;                    ///< Start time of the current slot (s)
+    float slotMean;                        ///< Mean of the current slot (0.1 Pa)
+    uint32_t sumY;                         ///< Sum of the completed slots
+    int64_t sumXY;                         ///< Sum of slot index x slot value, oldest slot is index 0
+    uint32_t slots[BME688_TREND_CAPACITY]; ///< Completed slot means (0.1 Pa)
+};
+
+/**
+ * @class BME688PressureTrend
+ * @brief Tracks pressure tendency over a fixed-size ring of decimated samples.
+ *
+ * Samples are averaged into slots of a fixed length and only completed slots enter the history.
+ * The least-squares sums are updated when a slot completes, so adding a sample and reading the
+ * slope are both O(1). Time is supplied by the caller in seconds (e.g. from an RTC), so the
+ * history survives deep sleep when the state is saved and restored.
+ */
+class BME688PressureTrend
+{
+  public:
+    /**
+     * @brief Creates an empty trend tracker.
+     * @param interval Slot length in seconds.
+     */
+    BME688PressureTrend(uint32_t interval = BME688_TREND_INTERVAL);
+
+    /**
+     * @brief Adds a pressure sample.
+     *
+     * A gap of several slots repeats the last completed slot; a gap longer than the whole
+     * history, or time going backwards, clears it.
+     * @param time Sample time in seconds.
+     * @param pressure Pressure in Pascals (Pa).
+     */
+    void add(uint32_t time, float pressure);
+
+    /**
+     * @brief Returns the number of completed slots in the history.
+     * @return Slot count.
+     */
+    uint8_t size() const;
+
+    /**
+     * @brief Returns the most recent completed slot.
+     * @return Pressure in Pa, or NAN if the history is empty.
+     */
+    float latest() const;
+
+    /**
+     * @brief Returns the pressure change over a horizon (e.g. 10800 s for the 3-hour tendency).
+     * @param horizon Horizon in seconds, rounded down to whole slots.
+     * @return Newest minus older slot in Pa, or NAN if the history is shorter than the horizon.
+     */
+    float tendency(uint32_t horizon) const;
+
+    /**
+     * @brief Returns the least-squares slope over the whole history.
+     * @return Slope in Pa per hour, or NAN with fewer than two slots.
+     */
+    float slope() const;
+
+    /**
+     * @brief Clears the history.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the state to save before deep sleep.
+     * @return State record.
+     */
+    const BME688TrendState &state() const;
+
+    /**
+     * @brief Restores a previously saved state.
+     * @param saved State returned by state().
+     * @return True if the state was valid and restored, false otherwise (the tracker is unchanged).
+     */
+    bool restore(const BME688TrendState &saved);
+
+  private:
+    BME688TrendState s;
+
+    void push(uint32_t value);
+    uint32_t slot(uint8_t age) const;
+};
+
+#endif // __cplusplus
+#endif // BME688_TREND_H
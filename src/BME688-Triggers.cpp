@@ -0,0 +1,210 @@
+/**
+ **************************************************
+ *
+ * @file        BME688-Triggers.cpp
+ * @brief       Deadband, threshold and heartbeat triggers for
+ *              report-on-change sampling with the BME688
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#include <BME688-Triggers.h>
+
+// Threshold states
+#define BME688_STATE_NORMAL 0
+#define BME688_STATE_HIGH   1
+#define BME688_STATE_LOW    2
+
+/**
+ * @brief Constructor for the trigger set (all triggers disabled)
+ */
+BME688Triggers::BME688Triggers()
+{
+    memset(channels, 0, sizeof(channels));
+}
+
+/**
+ * @brief Set the deadband of a channel
+ *
+ * @param channel Channel index
+ * @param deadband Deadband in sample units, 0 to disable
+ */
+void BME688Triggers::setDeadband(uint8_t channel, uint32_t deadband)
+{
+    if (channel < BME688_CHANNEL_COUNT)
+        channels[channel].deadband = deadband;
+}
+
+/**
+ * @brief Set the thresholds of a channel
+ *
+ * @param channel Channel index
+ * @param low Low threshold in sample units
+ * @param high High threshold in sample units
+ * @param hysteresis Hysteresis in sample units
+ */
+void BME688Triggers::setThresholds(uint8_t channel, int32_t low, int32_t high, uint32_t hysteresis)
+{
+    if (channel >= BME688_CHANNEL_COUNT)
+        return;
+    channels[channel].low = low;
+    channels[channel].high = high;
+    channels[channel].hysteresis = hysteresis;
+    channels[channel].state = BME688_STATE_NORMAL;
+    channels[channel].thresholds = true;
+}
+
+/**
+ * @brief Disable the thresholds of a channel
+ *
+ * @param channel Channel index
+ */
+void BME688Triggers::clearThresholds(uint8_t channel)
+{
+    if (channel < BME688_CHANNEL_COUNT)
+        channels[channel].thresholds = false;
+}
+
+/**
+ * @brief Set the heartbeat interval
+ *
+ * @param interval Interval in ms, 0 to disable
+ */
+void BME688Triggers::setHeartbeat(uint32_t interval)
+{
+    heartbeat = interval;
+}
+
+/**
+ * @brief Set the trigger callback
+ *
+ * @param callback Function to call, NULL to disable
+ * @param context Passed to the callback
+ */
+void BME688Triggers::setCallback(BME688TriggerCallback callback, void *context)
+{
+    this->callback = callback;
+    callbackContext = context;
+}
+
+/**
+ * @brief Forget the last report
+ */
+void BME688Triggers::reset()
+{
+    reported = false;
+    for (uint8_t i = 0; i < BME688_CHANNEL_COUNT; i++)
+        channels[i].state = BME688_STATE_NORMAL;
+}
+
+/**
+ * @brief Check whether events are pending
+ *
+ * @return true if any event fired since the last takeEvents()
+ */
+bool BME688Triggers::pending() const
+{
+    return events != 0;
+}
+
+/**
+ * @brief Return and clear the pending events
+ *
+ * @return uint8_t BME688_EVENT_* flags
+ */
+uint8_t BME688Triggers::takeEvents()
+{
+    uint8_t fired = events;
+    events = 0;
+    return fired;
+}
+
+/**
+ * @brief Evaluate the deadband and thresholds of one channel
+ *
+ * @param c Channel state
+ * @param value Value in sample units
+ * @return uint8_t BME688_EVENT_* flags
+ */
+uint8_t BME688Triggers::check(Channel &c, int32_t value)
+{
+    uint8_t fired = 0;
+
+    if (c.deadband && reported)
+    {
+        uint32_t diff = value > c.reference ? (uint32_t)value - (uint32_t)c.reference
+                                            : (uint32_t)c.reference - (uint32_t)value;
+        if (diff >= c.deadband)
+            fired |= BME688_EVENT_DEADBAND;
+    }
+
+    if (!c.thresholds)
+        return fired;
+
+    if (c.state == BME688_STATE_HIGH && (int64_t)value < (int64_t)c.high - c.hysteresis)
+    {
+        c.state = BME688_STATE_NORMAL;
+        fired |= BME688_EVENT_NORMAL;
+    }
+    else if (c.state == BME688_STATE_LOW && (int64_t)value > (int64_t)c.low + c.hysteresis)
+    {
+        c.state = BME688_STATE_NORMAL;
+        fired |= BME688_EVENT_NORMAL;
+    }
+
+    if (c.state != BME688_STATE_HIGH && value >= c.high)
+    {
+        c.state = BME688_STATE_HIGH;
+        fired = (fired & ~BME688_EVENT_NORMAL) | BME688_EVENT_HIGH;
+    }
+    else if (c.state != BME688_STATE_LOW && value <= c.low)
+    {
+        c.state = BME688_STATE_LOW;
+        fired = (fired & ~BME688_EVENT_NORMAL) | BME688_EVENT_LOW;
+    }
+    return fired;
+}
+
+/**
+ * @brief Evaluate all triggers for a sample
+ *
+ * @param sample Sample to evaluate
+ * @return uint8_t BME688_EVENT_* flags fired by this sample
+ */
+uint8_t BME688Triggers::evaluate(const BME688Sample &sample)
+{
+    int32_t values[BME688_CHANNEL_COUNT] = {
+        sample.temperature, (int32_t)sample.pressure, sample.humidity,
+        sample.gasResistance > 0x7FFFFFFF ? 0x7FFFFFFF : (int32_t)sample.gasResistance};
+    uint8_t fired = 0, fromChannels = 0;
+
+    for (uint8_t i = 0; i < BME688_CHANNEL_COUNT; i++)
+    {
+        if (!(sample.status & (1 << i)))
+            continue;
+        uint8_t channelEvents = check(channels[i], values[i]);
+        if (channelEvents)
+            fromChannels |= 1 << i;
+        fired |= channelEvents;
+    }
+
+    if (!reported || (heartbeat && sample.timestamp - lastReport >= heartbeat))
+        fired |= BME688_EVENT_HEARTBEAT;
+    if (!fired)
+        return 0;
+
+    // This sample is reported, so it becomes the reference for the next deadband check
+    for (uint8_t i = 0; i < BME688_CHANNEL_COUNT; i++)
+        if (sample.status & (1 << i))
+            channels[i].reference = values[i];
+    lastReport = sample.timestamp;
+    reported = true;
+
+    events |= fired;
+    if (callback)
+        callback(sample, fired, fromChannels, callbackContext);
+    return fired;
+}
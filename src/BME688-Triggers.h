@@ -0,0 +1,131 @@
+/**
+ **************************************************
+ * @file        BME688-Triggers.h
+ * @brief       Deadband, threshold and heartbeat triggers for
+ *              report-on-change sampling with the BME688
+ *
+ * @copyright   GNU General Public License v3.0
+ * @authors     Original Author: Saurav Sajeev (https://github.com/styropyr0)
+ *              Modifications by: Josip Šimun Kuči @ Soldered.com
+ * @date        Last modified: 2025-07-23
+ ***************************************************/
+
+#ifndef BME688_TRIGGERS_H
+#define BME688_TRIGGERS_H
+
+#include "BME688-Soldered.h"
+
+#ifdef __cplusplus
+
+// Trigger Events
+#define BME688_EVENT_DEADBAND  0x01 ///< A channel moved by at least its deadband since the last report
+#define BME688_EVENT_HIGH      0x02 ///< A channel rose to or above its high threshold
+#define BME688_EVENT_LOW       0x04 ///< A channel fell to or below its low threshold
+#define BME688_EVENT_NORMAL    0x08 ///< A channel returned inside its thresholds (past the hysteresis)
+#define BME688_EVENT_HEARTBEAT 0x10 ///< Heartbeat interval elapsed, or first sample
+
+/**
+ * @brief Called when a sample fires any trigger.
+ * @param sample The sample that fired.
+ * @param events BME688_EVENT_* flags.
+ * @param channels Bit mask of the channels that fired (1 << BME688_CHANNEL_*).
+ * @param context Context passed to BME688Triggers::setCallback().
+ */
+typedef void (*BME688TriggerCallback)(const BME688Sample &sample, uint8_t events, uint8_t channels, void *context);
+
+/**
+ * @class BME688Triggers
+ * @brief Per-channel deadband and threshold triggers with hysteresis and a heartbeat fallback.
+ *
+ * All checks are integer comparisons in the scaled units of BME688Sample, so they are cheap
+ * enough to run on every sample. When a sample fires, it becomes the new deadband reference
+ * for every channel, matching an application that reports the whole sample.
+ */
+class BME688Triggers
+{
+  public:
+    BME688Triggers();
+
+    /**
+     * @brief Sets the deadband of a channel.
+     * @param channel Channel index (BME688_CHANNEL_*).
+     * @param deadband Change from the last report that fires, in sample units (0 = disabled).
+     */
+    void setDeadband(uint8_t channel, uint32_t deadband);
+
+    /**
+     * @brief Sets absolute thresholds of a channel.
+     *
+     * The high event fires when the value reaches high, and the channel returns to normal once it
+     * drops below high - hysteresis. The low threshold works the same way in the other direction.
+     * @param channel Channel index (BME688_CHANNEL_*).
+     * @param low Low threshold in sample units.
+     * @param high High threshold in sample units.
+     * @param hysteresis Distance needed to return to normal, in sample units.
+     */
+    void setThresholds(uint8_t channel, int32_t low, int32_t high, uint32_t hysteresis = 0);
+
+    /**
+     * @brief Disables the thresholds of a channel.
+     * @param channel Channel index (BME688_CHANNEL_*).
+     */
+    void clearThresholds(uint8_t channel);
+
+    /**
+     * @brief Sets the longest time between reports.
+     * @param interval Heartbeat interval in milliseconds (0 = disabled).
+     */
+    void setHeartbeat(uint32_t interval);
+
+    /**
+     * @brief Sets a callback that is called whenever a sample fires.
+     * @param callback Function to call, or NULL to disable.
+     * @param context Passed to the callback.
+     */
+    void setCallback(BME688TriggerCallback callback, void *context = NULL);
+
+    /**
+     * @brief Evaluates all triggers for a sample.
+     * @param sample Sample to evaluate. Only channels flagged in its status are checked.
+     * @return BME688_EVENT_* flags fired by this sample, 0 if none.
+     */
+    uint8_t evaluate(const BME688Sample &sample);
+
+    /**
+     * @brief Checks whether any event fired since the last takeEvents().
+     * @return True if events are pending.
+     */
+    bool pending() const;
+
+    /**
+     * @brief Returns and clears the pending events.
+     * @return BME688_EVENT_* flags accumulated since the last call.
+     */
+    uint8_t takeEvents();
+
+    /**
+     * @brief Forgets the last report, so the next sample fires a heartbeat.
+     */
+    void reset();
+
+  private:
+    struct Channel
+    {
+        int32_t reference, low, high;
+        uint32_t deadband, hysteresis;
+        uint8_t state;
+        bool thresholds;
+    };
+
+    Channel channels[BME688_CHANNEL_COUNT];
+    uint32_t heartbeat = 0, lastReport = 0;
+    bool reported = false;
+    volatile uint8_t events = 0;
+    BME688TriggerCallback callback = NULL;
+    void *callbackContext = NULL;
+
+    uint8_t check(Channel &c, int32_t value);
+};
+
+#endif // __cplusplus
+#endif // BME688_TRIGGERS_H